@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: PMPL-1.0
+// SPDX-FileCopyrightText: 2025 Hyperpolymath
+//! FFI call-overhead benchmarks for the Idris 2 bridge
+//!
+//! `zig build bench` builds this natively and for wasm32-wasi (run under
+//! wasmtime) with allocation counting enabled. Each case reports mean
+//! ns/op and allocations/op, and the whole run prints one JSON object.
+//! The C-ABI exports are called through extern declarations, exactly as
+//! Idris-generated code calls them.
+//!
+//! Usage: zig build bench [-- iterations]
+
+const std = @import("std");
+const builtin = @import("builtin");
+const ffi = @import("idris2_zig_ffi");
+
+const native = ffi.abi.native;
+const IdrisValue = ffi.idris_rts.IdrisValue;
+
+extern fn idris2_alloc(size: usize) callconv(.C) ?*anyopaque;
+extern fn idris2_free(ptr: ?*anyopaque, size: usize) callconv(.C) void;
+extern fn idris2_result_ok_int(value: i64) callconv(.C) native.CResult;
+extern fn idris2_result_err(code: u32, msg: [*:0]const u8) callconv(.C) native.CResult;
+extern fn idris2_option_some_int(value: i64) callconv(.C) native.COption;
+extern fn idris2_option_none() callconv(.C) native.COption;
+
+const default_iterations = 1_000_000;
+const max_results = 32;
+
+const Result = struct {
+    group: []const u8,
+    name: []const u8,
+    iterations: usize,
+    ns_per_op: f64,
+    allocs_per_op: f64,
+};
+
+var results: [max_results]Result = undefined;
+var result_count: usize = 0;
+
+/// Run `body.run(i)` `iterations` times after a short warm-up and record
+/// mean time and allocator calls per iteration
+fn bench(group: []const u8, name: []const u8, iterations: usize, body: anytype) void {
+    for (0..iterations / 16) |i| body.run(i);
+
+    ffi.memory.resetAllocStats();
+    var timer = std.time.Timer.start() catch return;
+    for (0..iterations) |i| body.run(i);
+    const elapsed = timer.read();
+    const stats = ffi.memory.allocStats();
+
+    if (result_count == max_results) return;
+    const n: f64 = @floatFromInt(iterations);
+    results[result_count] = .{
+        .group = group,
+        .name = name,
+        .iterations = iterations,
+        .ns_per_op = @as(f64, @floatFromInt(elapsed)) / n,
+        .allocs_per_op = @as(f64, @floatFromInt(stats.allocs)) / n,
+    };
+    result_count += 1;
+}
+
+// ============================================================================
+// Cases
+// ============================================================================
+
+const AllocFree = struct {
+    size: usize,
+
+    fn run(self: AllocFree, _: usize) void {
+        const p = idris2_alloc(self.size);
+        std.mem.doNotOptimizeAway(p);
+        idris2_free(p, self.size);
+    }
+};
+
+const ToIdrisString = struct {
+    text: []const u8,
+
+    fn run(self: ToIdrisString, _: usize) void {
+        const s = ffi.types.toIdrisString(self.text);
+        std.mem.doNotOptimizeAway(&s);
+        ffi.memory.freeIdrisString(s);
+    }
+};
+
+const SliceRoundTrip = struct {
+    items: []const i64,
+
+    fn run(self: SliceRoundTrip, _: usize) void {
+        const list = ffi.types.toSlice(i64, self.items) catch return;
+        const back = ffi.types.fromSlice(i64, list) catch return;
+        std.mem.doNotOptimizeAway(back.ptr);
+        if (list.len > 0) {
+            const Node = ffi.idris_rts.IdrisListNode(i64);
+            const nodes: [*]Node = @ptrCast(list.head.?);
+            ffi.memory.allocator.free(nodes[0..list.len]);
+            ffi.memory.allocator.free(back);
+        }
+    }
+};
+
+fn echo(args: []const IdrisValue) IdrisValue {
+    return if (args.len > 0) args[0] else .{ .int = 0 };
+}
+
+const InvokeByName = struct {
+    args: []const IdrisValue,
+
+    fn run(self: InvokeByName, _: usize) void {
+        std.mem.doNotOptimizeAway(ffi.callbacks.invoke("bench.echo", self.args));
+    }
+};
+
+const InvokeById = struct {
+    id: u32,
+    args: []const IdrisValue,
+
+    fn run(self: InvokeById, _: usize) void {
+        std.mem.doNotOptimizeAway(ffi.callbacks.invokeById(self.id, self.args));
+    }
+};
+
+const ResultOk = struct {
+    fn run(_: ResultOk, i: usize) void {
+        const r = idris2_result_ok_int(@intCast(i));
+        std.mem.doNotOptimizeAway(r.value.int);
+    }
+};
+
+const ResultErr = struct {
+    fn run(_: ResultErr, _: usize) void {
+        const r = idris2_result_err(22, "invalid argument");
+        std.mem.doNotOptimizeAway(r.error_code);
+    }
+};
+
+const OptionSomeNone = struct {
+    fn run(_: OptionSomeNone, i: usize) void {
+        const o = if (i & 1 == 0) idris2_option_some_int(@intCast(i)) else idris2_option_none();
+        std.mem.doNotOptimizeAway(o.has_value);
+    }
+};
+
+// ============================================================================
+// Main
+// ============================================================================
+
+pub fn main() !void {
+    const args = try std.process.argsAlloc(std.heap.page_allocator);
+    defer std.process.argsFree(std.heap.page_allocator, args);
+    // At least one run: per-op figures divide by the count
+    const iterations = @max(1, if (args.len > 1)
+        std.fmt.parseInt(usize, args[1], 10) catch default_iterations
+    else
+        default_iterations);
+
+    try ffi.init();
+    defer ffi.deinit();
+
+    bench("alloc", "idris2_alloc_free_16", iterations, AllocFree{ .size = 16 });
+    bench("alloc", "idris2_alloc_free_4k", iterations, AllocFree{ .size = 4096 });
+
+    bench("string", "toIdrisString_inline_12", iterations, ToIdrisString{ .text = "short string" });
+    bench("string", "toIdrisString_heap_64", iterations, ToIdrisString{ .text = "x" ** 64 });
+
+    var items: [16]i64 = undefined;
+    for (&items, 0..) |*x, i| x.* = @intCast(i);
+    bench("list", "toSlice_fromSlice_16", iterations, SliceRoundTrip{ .items = &items });
+
+    const id = try ffi.callbacks.register("bench.echo", echo);
+    defer ffi.callbacks.unregister("bench.echo");
+    const cb_args = [_]IdrisValue{.{ .int = 42 }};
+    bench("callback", "invoke_by_name", iterations, InvokeByName{ .args = &cb_args });
+    bench("callback", "invoke_by_id", iterations, InvokeById{ .id = id, .args = &cb_args });
+
+    bench("result", "idris2_result_ok_int", iterations, ResultOk{});
+    bench("result", "idris2_result_err", iterations, ResultErr{});
+    bench("result", "idris2_option_some_none", iterations, OptionSomeNone{});
+
+    const out = std.io.getStdOut().writer();
+    try out.print("{{\n  \"target\": \"{s}-{s}\",\n  \"allocator\": \"{s}\",\n  \"iterations\": {d},\n  \"results\": [\n", .{
+        @tagName(builtin.cpu.arch), @tagName(builtin.os.tag), @tagName(ffi.memory.backend), iterations,
+    });
+    for (results[0..result_count], 0..) |r, i| {
+        try out.print("    {{\"group\": \"{s}\", \"name\": \"{s}\", \"iterations\": {d}, \"ns_per_op\": {d:.3}, \"allocs_per_op\": {d:.3}}}{s}\n", .{
+            r.group, r.name, r.iterations, r.ns_per_op, r.allocs_per_op, if (i + 1 < result_count) "," else "",
+        });
+    }
+    try out.writeAll("  ]\n}\n");
+}
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: PMPL-1.0
+// SPDX-FileCopyrightText: 2025 Hyperpolymath
+//! SIMD128 harness for the bulk helpers (src/bulk.zig)
+//!
+//! `zig build test-wasm-simd` builds this for wasm32-wasi twice, with and
+//! without simd128, and runs both under wasmtime. Each run checks every
+//! vector helper against its scalar reference on the same inputs, times
+//! both, and prints one JSON object. Any mismatch exits non-zero.
+//!
+//! Usage: wasmtime wasm_simd_harness.wasm [iterations]
+
+const std = @import("std");
+const bulk = @import("bulk");
+
+const data_len = 1 << 20;
+const default_iterations = 100;
+
+const Timing = struct {
+    name: []const u8,
+    vector_ns: u64,
+    scalar_ns: u64,
+};
+
+/// Mean ns per call of func(args) over `iterations` runs
+fn measure(iterations: usize, comptime func: anytype, args: anytype) u64 {
+    var timer = std.time.Timer.start() catch return 0;
+    for (0..iterations) |_| {
+        std.mem.doNotOptimizeAway(@call(.never_inline, func, args));
+    }
+    return timer.read() / iterations;
+}
+
+fn check(name: []const u8, ok: bool) usize {
+    if (ok) return 0;
+    std.debug.print("MISMATCH: {s}: vector and scalar results differ\n", .{name});
+    return 1;
+}
+
+pub fn main() !void {
+    const allocator = std.heap.page_allocator;
+
+    const args = try std.process.argsAlloc(allocator);
+    defer std.process.argsFree(allocator, args);
+    // At least one run: measure divides by the count
+    const iterations = @max(1, if (args.len > 1)
+        std.fmt.parseInt(usize, args[1], 10) catch default_iterations
+    else
+        default_iterations);
+
+    // Mostly-ASCII text with a multi-byte character near the end
+    const text = try allocator.alloc(u8, data_len);
+    defer allocator.free(text);
+    for (text, 0..) |*c, i| c.* = @intCast(' ' + i % 95);
+    @memcpy(text[data_len - 8 ..][0..2], "\xc3\xa9");
+
+    const invalid = try allocator.dupe(u8, text);
+    defer allocator.free(invalid);
+    invalid[data_len - 7] = 'x'; // truncates the two-byte sequence
+
+    const other = try allocator.dupe(u8, text);
+    defer allocator.free(other);
+    other[data_len - 3] ^= 1;
+
+    const dst = try allocator.alloc(u8, data_len);
+    defer allocator.free(dst);
+
+    const floats = try allocator.alloc(f64, data_len / 8);
+    defer allocator.free(floats);
+    for (floats, 0..) |*x, i| x.* = @as(f64, @floatFromInt(i % 1000)) * 0.5;
+
+    // Correctness: vector helpers against scalar references
+    var failures: usize = 0;
+    failures += check("validate_utf8", bulk.validateUtf8(text) == bulk.validateUtf8Scalar(text));
+    failures += check("validate_utf8_invalid", bulk.validateUtf8(invalid) == bulk.validateUtf8Scalar(invalid));
+    failures += check("compare", bulk.compare(text, other) == bulk.compareScalar(text, other));
+    failures += check("compare_equal", bulk.compare(text, text) == .eq);
+    failures += check("sum_u8", bulk.sumBytes(text) == bulk.sumBytesScalar(text));
+    failures += check("sum_f64", std.math.approxEqRel(f64, bulk.sumF64(floats), bulk.sumF64Scalar(floats), 1e-12));
+    bulk.copy(dst, text);
+    failures += check("copy", std.mem.eql(u8, dst, text));
+
+    // Timings
+    const timings = [_]Timing{
+        .{
+            .name = "validate_utf8",
+            .vector_ns = measure(iterations, bulk.validateUtf8, .{text}),
+            .scalar_ns = measure(iterations, bulk.validateUtf8Scalar, .{text}),
+        },
+        .{
+            .name = "copy",
+            .vector_ns = measure(iterations, bulk.copy, .{ dst, text }),
+            .scalar_ns = measure(iterations, bulk.copyScalar, .{ dst, text }),
+        },
+        .{
+            .name = "compare",
+            .vector_ns = measure(iterations, bulk.compare, .{ text, other }),
+            .scalar_ns = measure(iterations, bulk.compareScalar, .{ text, other }),
+        },
+        .{
+            .name = "sum_u8",
+            .vector_ns = measure(iterations, bulk.sumBytes, .{text}),
+            .scalar_ns = measure(iterations, bulk.sumBytesScalar, .{text}),
+        },
+        .{
+            .name = "sum_f64",
+            .vector_ns = measure(iterations, bulk.sumF64, .{floats}),
+            .scalar_ns = measure(iterations, bulk.sumF64Scalar, .{floats}),
+        },
+    };
+
+    const out = std.io.getStdOut().writer();
+    try out.print("{{\"simd128\": {}, \"bytes\": {d}, \"iterations\": {d}, \"failures\": {d}, \"results\": [\n", .{
+        bulk.wasm_simd_enabled, data_len, iterations, failures,
+    });
+    for (timings, 0..) |t, i| {
+        try out.print("  {{\"name\": \"{s}\", \"vector_ns\": {d}, \"scalar_ns\": {d}}}{s}\n", .{
+            t.name, t.vector_ns, t.scalar_ns, if (i + 1 < timings.len) "," else "",
+        });
+    }
+    try out.writeAll("]}\n");
+
+    if (failures > 0) std.process.exit(1);
+}
@@ -10,15 +10,66 @@
 //! - `zig build` - Build native static library
 //! - `zig build wasm` - Build WASM library for browsers
 //! - `zig build wasi` - Build WASI library for runtimes
+//! - `zig build wasm-simd` - Build WASM library for browsers with SIMD128
+//! - `zig build test-wasm-simd` - Check and time SIMD128 helpers under wasmtime
+//! - `zig build bench` - FFI call-overhead benchmarks, native and under wasmtime
 //! - `zig build test` - Run unit tests
 //! - `zig build docs` - Generate documentation
+//!
+//! ## Options
+//!
+//! - `-Dallocator=gpa|c|page` - Allocator backing `memory.allocator`.
+//!   Defaults to `gpa` (safety-checking) in Debug and `c` (libc malloc, or
+//!   jemalloc/mimalloc when linked in its place) in release builds.
+//!   WASM targets always use the WASM page-based allocator; `wasm` is
+//!   accepted but only compiles when the native target is itself WASM.
+//! - `-Dalloc-stats` - Count calls through `memory.allocator`
+//!   (`memory.allocStats`). Always on for the benchmarks.
+//! - `-Dwasmtime=<path>` - WASM runtime used by test-wasm-simd and bench
 
 const std = @import("std");
 
+/// Allocator backends selectable with -Dallocator
+pub const AllocatorBackend = enum {
+    /// std.heap.GeneralPurposeAllocator: leak/double-free checks, global mutex
+    gpa,
+    /// std.heap.c_allocator: libc malloc with its per-thread caches
+    c,
+    /// std.heap.page_allocator: direct OS pages
+    page,
+    /// std.heap.wasm_allocator (selected automatically for WASM targets;
+    /// -Dallocator=wasm is a compile error for other targets)
+    wasm,
+};
+
 pub fn build(b: *std.Build) void {
     const target = b.standardTargetOptions(.{});
     const optimize = b.standardOptimizeOption(.{});
 
+    // ========================================================================
+    // Allocator selection
+    // ========================================================================
+    const allocator_option = b.option(
+        AllocatorBackend,
+        "allocator",
+        "Allocator backend (default: gpa in Debug, c otherwise)",
+    );
+    const allocator_backend = allocator_option orelse
+        if (optimize == .Debug) AllocatorBackend.gpa else AllocatorBackend.c;
+    const link_libc = allocator_backend == .c;
+    const alloc_stats = b.option(bool, "alloc-stats", "Count allocations through memory.allocator") orelse false;
+    const refc_runtime = b.option(bool, "refc-runtime", "Link GC roots to the RefC runtime's newReference/removeReference") orelse false;
+
+    const build_options = b.addOptions();
+    build_options.addOption(AllocatorBackend, "allocator", allocator_backend);
+    build_options.addOption(bool, "alloc_stats", alloc_stats);
+    build_options.addOption(bool, "refc_runtime", refc_runtime);
+
+    const wasm_build_options = b.addOptions();
+    wasm_build_options.addOption(AllocatorBackend, "allocator", .wasm);
+    wasm_build_options.addOption(bool, "alloc_stats", alloc_stats);
+    wasm_build_options.addOption(bool, "refc_runtime", false);
+
     // ========================================================================
     // Main library module (for Zig consumers)
     // ========================================================================
@@ -26,7 +77,9 @@ pub fn build(b: *std.Build) void {
         .root_source_file = b.path("src/root.zig"),
         .target = target,
         .optimize = optimize,
+        .link_libc = link_libc,
     });
+    lib_mod.addOptions("build_options", build_options);
 
     // ========================================================================
     // Native static library (Pure Zig ABI)
@@ -36,7 +89,9 @@ pub fn build(b: *std.Build) void {
         .root_source_file = b.path("src/root.zig"),
         .target = target,
         .optimize = optimize,
+        .link_libc = link_libc,
     });
+    lib.root_module.addOptions("build_options", build_options);
     b.installArtifact(lib);
 
     // ========================================================================
@@ -47,7 +102,9 @@ pub fn build(b: *std.Build) void {
         .root_source_file = b.path("src/root.zig"),
         .target = target,
         .optimize = optimize,
+        .link_libc = link_libc,
     });
+    shared_lib.root_module.addOptions("build_options", build_options);
 
     const shared_step = b.step("shared", "Build shared library (.so/.dylib/.dll)");
     shared_step.dependOn(&b.addInstallArtifact(shared_lib, .{}).step);
@@ -66,6 +123,7 @@ pub fn build(b: *std.Build) void {
     });
     // Don't link libc for freestanding WASM
     wasm_browser.rdynamic = true;
+    wasm_browser.root_module.addOptions("build_options", wasm_build_options);
 
     const wasm_browser_step = b.step("wasm", "Build WASM library for browsers");
     const wasm_browser_install = b.addInstallArtifact(wasm_browser, .{});
@@ -84,17 +142,139 @@ pub fn build(b: *std.Build) void {
         .optimize = .ReleaseSmall,
     });
     wasm_wasi.rdynamic = true;
+    wasm_wasi.root_module.addOptions("build_options", wasm_build_options);
 
     const wasm_wasi_step = b.step("wasi", "Build WASI library for runtimes");
     const wasm_wasi_install = b.addInstallArtifact(wasm_wasi, .{});
     wasm_wasi_step.dependOn(&wasm_wasi_install.step);
 
+    // ========================================================================
+    // WASM (Browser) with SIMD128 - optional variant
+    // ========================================================================
+    const simd128 = std.Target.wasm.featureSet(&.{.simd128});
+    const wasm_simd = b.addSharedLibrary(.{
+        .name = "idris2_zig_ffi_simd",
+        .root_source_file = b.path("src/root.zig"),
+        .target = b.resolveTargetQuery(.{
+            .cpu_arch = .wasm32,
+            .os_tag = .freestanding,
+            .cpu_features_add = simd128,
+        }),
+        .optimize = .ReleaseSmall,
+    });
+    wasm_simd.rdynamic = true;
+    wasm_simd.root_module.addOptions("build_options", wasm_build_options);
+
+    const wasm_simd_step = b.step("wasm-simd", "Build WASM library for browsers with SIMD128");
+    wasm_simd_step.dependOn(&b.addInstallArtifact(wasm_simd, .{}).step);
+
     // ========================================================================
     // All WASM targets
     // ========================================================================
     const all_wasm_step = b.step("all-wasm", "Build all WASM targets");
     all_wasm_step.dependOn(wasm_browser_step);
     all_wasm_step.dependOn(wasm_wasi_step);
+    all_wasm_step.dependOn(wasm_simd_step);
+
+    // ========================================================================
+    // SIMD128 harness (wasm32-wasi, run under wasmtime)
+    // ========================================================================
+    const wasmtime = b.option([]const u8, "wasmtime", "WASM runtime for test-wasm-simd and bench (default: wasmtime)") orelse "wasmtime";
+    const simd_test_step = b.step("test-wasm-simd", "Check and time SIMD128 helpers against scalar under wasmtime");
+
+    const harness_variants = [_]struct { name: []const u8, features: std.Target.Cpu.Feature.Set }{
+        .{ .name = "wasm_simd_harness", .features = simd128 },
+        .{ .name = "wasm_scalar_harness", .features = std.Target.Cpu.Feature.Set.empty },
+    };
+    for (harness_variants) |variant| {
+        const harness = b.addExecutable(.{
+            .name = variant.name,
+            .root_source_file = b.path("bench/wasm_simd.zig"),
+            .target = b.resolveTargetQuery(.{
+                .cpu_arch = .wasm32,
+                .os_tag = .wasi,
+                .cpu_features_add = variant.features,
+            }),
+            .optimize = .ReleaseFast,
+        });
+        harness.root_module.addImport("bulk", b.createModule(.{
+            .root_source_file = b.path("src/bulk.zig"),
+        }));
+
+        const run_harness = b.addSystemCommand(&.{wasmtime});
+        run_harness.addArtifactArg(harness);
+        if (b.args) |args| run_harness.addArgs(args);
+        simd_test_step.dependOn(&run_harness.step);
+    }
+
+    // ========================================================================
+    // FFI benchmarks (native, and wasm32-wasi under wasmtime)
+    // ========================================================================
+    // Always optimized and always counting allocations. Natively the
+    // -Dallocator choice is honoured (default c); the WASI run uses the
+    // WASM allocator. Freestanding wasm cannot run outside a browser, so
+    // the WASI build stands in for it.
+    const bench_step = b.step("bench", "Run FFI call-overhead benchmarks (native and wasmtime)");
+
+    const bench_backend = allocator_option orelse AllocatorBackend.c;
+    const bench_options = b.addOptions();
+    bench_options.addOption(AllocatorBackend, "allocator", bench_backend);
+    bench_options.addOption(bool, "alloc_stats", true);
+    bench_options.addOption(bool, "refc_runtime", false);
+
+    const wasm_bench_options = b.addOptions();
+    wasm_bench_options.addOption(AllocatorBackend, "allocator", .wasm);
+    wasm_bench_options.addOption(bool, "alloc_stats", true);
+    wasm_bench_options.addOption(bool, "refc_runtime", false);
+
+    const bench_variants = [_]struct {
+        name: []const u8,
+        target: std.Build.ResolvedTarget,
+        options: *std.Build.Step.Options,
+        link_libc: bool,
+        under_wasmtime: bool,
+    }{
+        .{
+            .name = "ffi_bench",
+            .target = target,
+            .options = bench_options,
+            .link_libc = bench_backend == .c,
+            .under_wasmtime = false,
+        },
+        .{
+            .name = "ffi_bench_wasi",
+            .target = b.resolveTargetQuery(.{ .cpu_arch = .wasm32, .os_tag = .wasi }),
+            .options = wasm_bench_options,
+            .link_libc = false,
+            .under_wasmtime = true,
+        },
+    };
+    for (bench_variants) |variant| {
+        const ffi_mod = b.createModule(.{
+            .root_source_file = b.path("src/root.zig"),
+            .target = variant.target,
+            .optimize = .ReleaseFast,
+            .link_libc = variant.link_libc,
+        });
+        ffi_mod.addOptions("build_options", variant.options);
+
+        const bench_exe = b.addExecutable(.{
+            .name = variant.name,
+            .root_source_file = b.path("bench/ffi_bench.zig"),
+            .target = variant.target,
+            .optimize = .ReleaseFast,
+            .link_libc = variant.link_libc,
+        });
+        bench_exe.root_module.addImport("idris2_zig_ffi", ffi_mod);
+
+        const run_bench = if (variant.under_wasmtime) blk: {
+            const run = b.addSystemCommand(&.{wasmtime});
+            run.addArtifactArg(bench_exe);
+            break :blk run;
+        } else b.addRunArtifact(bench_exe);
+        if (b.args) |args| run_bench.addArgs(args);
+        bench_step.dependOn(&run_bench.step);
+    }
 
     // ========================================================================
     // Tests
@@ -103,7 +283,9 @@ pub fn build(b: *std.Build) void {
         .root_source_file = b.path("src/root.zig"),
         .target = target,
         .optimize = optimize,
+        .link_libc = link_libc,
     });
+    lib_unit_tests.root_module.addOptions("build_options", build_options);
 
     const run_lib_unit_tests = b.addRunArtifact(lib_unit_tests);
 
@@ -118,7 +300,9 @@ pub fn build(b: *std.Build) void {
         .root_source_file = b.path("src/root.zig"),
         .target = target,
         .optimize = optimize,
+        .link_libc = link_libc,
     });
+    docs.root_module.addOptions("build_options", build_options);
 
     const install_docs = b.addInstallDirectory(.{
         .source_dir = docs.getEmittedDocs(),
@@ -17,6 +17,7 @@ const memory = @import("../memory.zig");
 const types = @import("../types.zig");
 const idris_rts = @import("../idris_rts.zig");
 const errors = @import("../errors.zig");
+const kernels = @import("../kernels.zig");
 
 // ============================================================================
 // ABI Version
@@ -24,10 +25,10 @@ const errors = @import("../errors.zig");
 
 /// Current ABI version
 /// Increment on breaking changes
-pub const ABI_VERSION: u32 = 1;
+pub const ABI_VERSION: u32 = 2;
 
 /// Minimum supported ABI version
-pub const ABI_VERSION_MIN: u32 = 1;
+pub const ABI_VERSION_MIN: u32 = 2;
 
 /// Check if a version is compatible
 pub fn isCompatible(version: u32) bool {
@@ -38,29 +39,10 @@ pub fn isCompatible(version: u32) bool {
 // ABI Types (extern struct for stability)
 // ============================================================================
 
-/// ABI-stable string (pointer + length)
-pub const CString = extern struct {
-    data: ?[*]u8,
-    len: usize,
-
-    pub fn fromSlice(slice: []const u8) CString {
-        return .{
-            .data = @constCast(slice.ptr),
-            .len = slice.len,
-        };
-    }
-
-    pub fn toSlice(self: CString) []const u8 {
-        if (self.data) |data| {
-            return data[0..self.len];
-        }
-        return "";
-    }
-
-    pub fn empty() CString {
-        return .{ .data = null, .len = 0 };
-    }
-};
+/// ABI-stable string (two words). Same representation as IdrisString:
+/// short strings are stored inline and `data`/`len` carry flag bits, so C
+/// callers read through idris2_string_data/idris2_string_len.
+pub const CString = idris_rts.IdrisString;
 
 /// C-compatible result type (success/error)
 pub const CResult = extern struct {
@@ -82,7 +64,19 @@ pub const CResult = extern struct {
         return .{
             .success = false,
             .error_code = code,
-            .error_msg = CString.fromSlice(msg),
+            .error_msg = CString.borrowed(msg),
+            .value = .{ .int = 0 },
+        };
+    }
+
+    /// Error whose message comes from the static message table; nothing
+    /// points into caller memory and nothing is allocated. `e.code` is a
+    /// native ErrorCode value.
+    pub fn errCompact(e: errors.CompactError) CResult {
+        return .{
+            .success = false,
+            .error_code = e.code,
+            .error_msg = CString.borrowed(compactMessage(e)),
             .value = .{ .int = 0 },
         };
     }
@@ -155,39 +149,82 @@ pub const ErrorCode = struct {
     // Runtime errors
     pub const NOT_INITIALIZED: u32 = 600;
     pub const ALREADY_INITIALIZED: u32 = 601;
+
+    /// Name of a native code. The C ABI numbers codes differently from
+    /// errors.ErrorCode, so its names cannot be used here.
+    pub fn describe(code: u32) []const u8 {
+        return switch (code) {
+            OK => "ok",
+            OUT_OF_MEMORY => "out_of_memory",
+            INVALID_POINTER => "invalid_pointer",
+            TYPE_MISMATCH => "type_mismatch",
+            INVALID_ARGUMENT => "invalid_argument",
+            PARSE_ERROR => "parse_error",
+            INVALID_INPUT => "invalid_input",
+            DIVISION_BY_ZERO => "division_by_zero",
+            OVERFLOW => "overflow",
+            UNDERFLOW => "underflow",
+            INJECTION_DETECTED => "injection_detected",
+            TRAVERSAL_DETECTED => "traversal_detected",
+            NOT_INITIALIZED => "not_initialized",
+            ALREADY_INITIALIZED => "already_initialized",
+            else => "unknown",
+        };
+    }
 };
 
+/// Message for a compact error carrying a native code: the registered
+/// message, else the native code's name
+fn compactMessage(e: errors.CompactError) []const u8 {
+    return errors.messageText(e.message_id) orelse ErrorCode.describe(e.code);
+}
+
 // ============================================================================
 // Initialization
 // ============================================================================
 
-var initialized: bool = false;
+/// Set by the idris2_init call that wins; later calls report
+/// ALREADY_INITIALIZED
+var initialized = std.atomic.Value(bool).init(false);
 
-/// Initialize the library
+/// Initialize the library. Thread-safe: exactly one caller runs the
+/// initialisation, and every caller returns only once it has finished.
 export fn idris2_init() callconv(.C) i32 {
-    if (initialized) {
-        return -@as(i32, @intCast(ErrorCode.ALREADY_INITIALIZED));
-    }
+    const first = initialized.cmpxchgStrong(false, true, .acq_rel, .acquire) == null;
 
     idris_rts.initRuntime() catch {
+        if (first) initialized.store(false, .release);
         return -@as(i32, @intCast(ErrorCode.UNKNOWN));
     };
 
-    initialized = true;
+    if (!first) {
+        return -@as(i32, @intCast(ErrorCode.ALREADY_INITIALIZED));
+    }
     return 0;
 }
 
 /// Cleanup the library
 export fn idris2_deinit() callconv(.C) void {
-    if (initialized) {
+    if (initialized.swap(false, .acq_rel)) {
         idris_rts.deinitRuntime();
-        initialized = false;
     }
 }
 
 /// Check if initialized
 export fn idris2_is_initialized() callconv(.C) bool {
-    return initialized;
+    return idris_rts.isInitialized();
+}
+
+/// Attach the calling thread (initialising the runtime if needed). Gives
+/// the thread its own marshalling scratch arena.
+export fn idris2_thread_attach() callconv(.C) i32 {
+    _ = idris_rts.attachThread() catch return -@as(i32, @intCast(ErrorCode.UNKNOWN));
+    return 0;
+}
+
+/// Release the calling thread's scratch memory; call before it exits
+export fn idris2_thread_detach() callconv(.C) void {
+    idris_rts.detachThread();
 }
 
 /// Get ABI version
@@ -204,77 +241,152 @@ export fn idris2_abi_compatible(version: u32) callconv(.C) bool {
 // Memory Management
 // ============================================================================
 
-/// Allocate memory
+/// Allocate memory. Buffers of memory.large_block_threshold bytes or more
+/// get their own page mapping on Linux so idris2_realloc can grow them in
+/// place.
 export fn idris2_alloc(size: usize) callconv(.C) ?*anyopaque {
-    const slice = memory.allocator.alloc(u8, size) catch return null;
-    return slice.ptr;
+    return memory.allocBytes(size);
 }
 
-/// Reallocate memory
+/// Reallocate memory (mremap for large buffers on Linux)
 export fn idris2_realloc(ptr: ?*anyopaque, old_size: usize, new_size: usize) callconv(.C) ?*anyopaque {
     if (ptr == null) {
         return idris2_alloc(new_size);
     }
-
-    const old_slice: []u8 = @as([*]u8, @ptrCast(ptr.?))[0..old_size];
-    const new_slice = memory.allocator.realloc(old_slice, new_size) catch return null;
-    return new_slice.ptr;
+    return memory.reallocBytes(@ptrCast(ptr.?), old_size, new_size);
 }
 
 /// Free memory
 export fn idris2_free(ptr: ?*anyopaque, size: usize) callconv(.C) void {
     if (ptr) |p| {
-        const slice: []u8 = @as([*]u8, @ptrCast(p))[0..size];
-        memory.allocator.free(slice);
+        memory.freeBytes(@ptrCast(p), size);
     }
 }
 
+/// Capacity to grow a buffer to so that it holds `needed` bytes
+/// (geometric growth, page-rounded for large buffers)
+export fn idris2_grow_capacity(current: usize, needed: usize) callconv(.C) usize {
+    return memory.growCapacity(current, needed);
+}
+
+/// Enable or disable transparent huge page advice for large buffers
+export fn idris2_set_huge_pages(enabled: bool) callconv(.C) void {
+    memory.setHugePages(enabled);
+}
+
+/// Allocate memory whose size is tracked by the bridge.
+/// Release with idris2_raw_free; no size needs to be kept by the caller.
+export fn idris2_raw_alloc(size: usize) callconv(.C) ?*anyopaque {
+    return memory.allocRaw(size);
+}
+
+/// Allocate size-tracked memory with a power-of-two alignment
+export fn idris2_raw_alloc_aligned(size: usize, alignment: usize) callconv(.C) ?*anyopaque {
+    return memory.allocRawAligned(size, alignment);
+}
+
+/// Free memory from idris2_raw_alloc
+export fn idris2_raw_free(ptr: ?*anyopaque) callconv(.C) void {
+    memory.freeRaw(ptr);
+}
+
+/// Size of a live idris2_raw_alloc block
+export fn idris2_raw_size(ptr: ?*anyopaque) callconv(.C) usize {
+    return if (ptr) |p| memory.rawSize(p) else 0;
+}
+
+// ============================================================================
+// GC Roots
+// ============================================================================
+
+/// Install the RefC newReference/removeReference functions used by
+/// idris2_gc_root_object. Hosts that link the RefC runtime without
+/// -Drefc-runtime call this once at startup; null restores the default.
+export fn idris2_gc_set_refc_hooks(hooks: ?*const idris_rts.RefcHooks) callconv(.C) void {
+    idris_rts.gcSetRefcHooks(if (hooks) |h| h.* else null);
+}
+
+/// Root a RefC object so Zig can keep referencing it across calls.
+/// Returns a handle, or 0 on allocation failure or if no RefC hooks are
+/// installed (see idris2_gc_set_refc_hooks).
+export fn idris2_gc_root_object(obj: ?*anyopaque) callconv(.C) u64 {
+    const handle = idris_rts.gcRootObject(obj orelse return 0) catch return 0;
+    return @intFromEnum(handle);
+}
+
+/// Object behind a root handle, or null if the handle is stale
+export fn idris2_gc_get_object(handle: u64) callconv(.C) ?*anyopaque {
+    return idris_rts.gcGetObject(@enumFromInt(handle));
+}
+
+/// Release a root (the RefC reference is dropped by idris2_gc_collect)
+export fn idris2_gc_unroot(handle: u64) callconv(.C) void {
+    idris_rts.gcUnroot(@enumFromInt(handle));
+}
+
+/// Drop queued RefC references; call on the Idris thread
+export fn idris2_gc_collect() callconv(.C) usize {
+    return idris_rts.gcCollect();
+}
+
 // ============================================================================
 // String Operations
 // ============================================================================
 
-/// Create a string from C string (null-terminated)
+/// Create a string from C string (null-terminated).
+/// Short strings are stored inline; longer ones are copied.
 export fn idris2_string_from_cstr(cstr: [*:0]const u8) callconv(.C) CString {
-    const len = std.mem.len(cstr);
-    const data = memory.allocator.alloc(u8, len) catch return CString.empty();
-    @memcpy(data, cstr[0..len]);
-    return .{ .data = data.ptr, .len = len };
+    return types.toIdrisString(std.mem.span(cstr));
 }
 
-/// Create a string from pointer + length
+/// Create a string from pointer + length (inline or copied, as above)
 export fn idris2_string_from_ptr(ptr: [*]const u8, len: usize) callconv(.C) CString {
-    const data = memory.allocator.alloc(u8, len) catch return CString.empty();
-    @memcpy(data, ptr[0..len]);
-    return .{ .data = data.ptr, .len = len };
+    return types.toIdrisString(ptr[0..len]);
+}
+
+/// Borrow a C string without copying. The caller keeps `cstr` alive while
+/// the result is in use; idris2_string_free on it is a no-op.
+export fn idris2_string_borrow_cstr(cstr: [*:0]const u8) callconv(.C) CString {
+    return CString.borrowed(std.mem.span(cstr));
+}
+
+/// Borrow pointer + length without copying (same lifetime rules)
+export fn idris2_string_borrow_ptr(ptr: [*]const u8, len: usize) callconv(.C) CString {
+    return CString.borrowed(ptr[0..len]);
+}
+
+/// Pointer to the string bytes (not null-terminated).
+/// For inline strings this points into `*str` itself.
+export fn idris2_string_data(str: *const CString) callconv(.C) ?[*]const u8 {
+    const bytes = str.slice();
+    return if (bytes.len > 0) bytes.ptr else null;
 }
 
 /// Convert string to null-terminated C string
 /// Caller must free with idris2_free(ptr, len+1)
 export fn idris2_string_to_cstr(str: CString) callconv(.C) ?[*:0]u8 {
-    if (str.data == null) return null;
+    const bytes = str.slice();
+    if (bytes.len == 0 and str.data == null) return null;
 
-    const data = memory.allocator.alloc(u8, str.len + 1) catch return null;
-    @memcpy(data[0..str.len], str.data.?[0..str.len]);
-    data[str.len] = 0;
-    return @ptrCast(data.ptr);
+    const data = memory.allocBytes(bytes.len + 1) orelse return null;
+    @memcpy(data[0..bytes.len], bytes);
+    data[bytes.len] = 0;
+    return @ptrCast(data);
 }
 
-/// Free a string
+/// Free a string (no-op for inline and borrowed strings)
 export fn idris2_string_free(str: CString) callconv(.C) void {
-    if (str.data) |data| {
-        const slice = data[0..str.len];
-        memory.allocator.free(slice);
-    }
+    memory.freeIdrisString(str);
 }
 
 /// Get string length
 export fn idris2_string_len(str: CString) callconv(.C) usize {
-    return str.len;
+    return str.length();
 }
 
 /// Compare two strings
 export fn idris2_string_eq(a: CString, b: CString) callconv(.C) bool {
-    return std.mem.eql(u8, a.toSlice(), b.toSlice());
+    return std.mem.eql(u8, a.slice(), b.slice());
 }
 
 // ============================================================================
@@ -321,6 +433,29 @@ export fn idris2_result_err(code: u32, msg: [*:0]const u8) callconv(.C) CResult
     return CResult.err(code, msg[0..len]);
 }
 
+/// Create Err(code) with a registered message id (0 = describe the code).
+/// Allocation-free; the message is static.
+export fn idris2_result_err_id(code: u32, message_id: u16) callconv(.C) CResult {
+    return CResult.errCompact(.{ .code = code, .message_id = @enumFromInt(message_id) });
+}
+
+/// Register a message for use with idris2_result_err_id. The string must
+/// stay valid for the life of the program. Returns 0 when the table is full.
+export fn idris2_error_register_message(msg: [*:0]const u8) callconv(.C) u16 {
+    const id = errors.registerMessage(std.mem.span(msg)) catch return 0;
+    return @intFromEnum(id);
+}
+
+/// Static message text for a compact error with a native code
+export fn idris2_error_message(err: errors.CompactError) callconv(.C) CString {
+    return CString.borrowed(compactMessage(err));
+}
+
+/// Thread-local detail for a compact error (empty once superseded)
+export fn idris2_error_context(err: errors.CompactError) callconv(.C) CString {
+    return CString.borrowed(err.context() orelse "");
+}
+
 /// Check if Ok
 export fn idris2_result_is_ok(result: CResult) callconv(.C) bool {
     return result.success;
@@ -366,6 +501,145 @@ export fn idris2_array_get(arr: CArray, index: usize) callconv(.C) CValue {
     return arr.data.?[index];
 }
 
+// ============================================================================
+// Typed Arrays (i64 / f64 / u8)
+// ============================================================================
+//
+// Homogeneous arrays of unboxed elements, addressed by pointer + length.
+// Whole-array work (copies, reductions, elementwise maps) is a single call
+// into the SIMD kernels in kernels.zig instead of one call per element.
+// Exported per element type as idris2_<type>_array_new, idris2_<type>_sum,
+// idris2_<type>_map_add and so on (see exportTypedArray).
+
+fn TypedArrayAbi(comptime T: type) type {
+    return struct {
+        const Acc = kernels.Acc(T);
+
+        /// Allocate `len` zeroed elements (free with *_array_free)
+        fn new(len: usize) callconv(.C) ?[*]T {
+            const data = memory.allocator.alloc(T, len) catch return null;
+            @memset(data, 0);
+            return data.ptr;
+        }
+
+        fn free(data: ?[*]T, len: usize) callconv(.C) void {
+            if (data) |d| memory.allocator.free(d[0..len]);
+        }
+
+        /// Bulk copy from a caller buffer into the array
+        fn copyIn(dst: [*]T, src: [*]const T, len: usize) callconv(.C) void {
+            @memcpy(dst[0..len], src[0..len]);
+        }
+
+        /// Bulk copy from the array into a caller buffer
+        fn copyOut(src: [*]const T, dst: [*]T, len: usize) callconv(.C) void {
+            @memcpy(dst[0..len], src[0..len]);
+        }
+
+        fn fill(dst: [*]T, len: usize, value: T) callconv(.C) void {
+            @memset(dst[0..len], value);
+        }
+
+        fn sum(data: [*]const T, len: usize) callconv(.C) Acc {
+            return kernels.sum(T, data[0..len]);
+        }
+
+        fn dot(a: [*]const T, b: [*]const T, len: usize) callconv(.C) Acc {
+            return kernels.dot(T, a[0..len], b[0..len]);
+        }
+
+        /// Minimum element (0 for an empty array)
+        fn min(data: [*]const T, len: usize) callconv(.C) T {
+            return kernels.min(T, data[0..len]) orelse 0;
+        }
+
+        /// Maximum element (0 for an empty array)
+        fn max(data: [*]const T, len: usize) callconv(.C) T {
+            return kernels.max(T, data[0..len]) orelse 0;
+        }
+
+        fn mapAdd(dst: [*]T, a: [*]const T, b: [*]const T, len: usize) callconv(.C) void {
+            kernels.map2(T, .add, dst[0..len], a[0..len], b[0..len]);
+        }
+
+        fn mapSub(dst: [*]T, a: [*]const T, b: [*]const T, len: usize) callconv(.C) void {
+            kernels.map2(T, .sub, dst[0..len], a[0..len], b[0..len]);
+        }
+
+        fn mapMul(dst: [*]T, a: [*]const T, b: [*]const T, len: usize) callconv(.C) void {
+            kernels.map2(T, .mul, dst[0..len], a[0..len], b[0..len]);
+        }
+
+        /// dst[i] = src[i] * k
+        fn mapScale(dst: [*]T, src: [*]const T, k: T, len: usize) callconv(.C) void {
+            kernels.mapScalar(T, .mul, dst[0..len], src[0..len], k);
+        }
+
+        /// dst[i] = src[i] + k
+        fn mapOffset(dst: [*]T, src: [*]const T, k: T, len: usize) callconv(.C) void {
+            kernels.mapScalar(T, .add, dst[0..len], src[0..len], k);
+        }
+    };
+}
+
+pub const I64Array = TypedArrayAbi(i64);
+pub const F64Array = TypedArrayAbi(f64);
+pub const U8Array = TypedArrayAbi(u8);
+
+fn exportTypedArray(comptime A: type, comptime name: []const u8) void {
+    const prefix = "idris2_" ++ name;
+    @export(A.new, .{ .name = prefix ++ "_array_new" });
+    @export(A.free, .{ .name = prefix ++ "_array_free" });
+    @export(A.copyIn, .{ .name = prefix ++ "_copy_in" });
+    @export(A.copyOut, .{ .name = prefix ++ "_copy_out" });
+    @export(A.fill, .{ .name = prefix ++ "_fill" });
+    @export(A.sum, .{ .name = prefix ++ "_sum" });
+    @export(A.dot, .{ .name = prefix ++ "_dot" });
+    @export(A.min, .{ .name = prefix ++ "_min" });
+    @export(A.max, .{ .name = prefix ++ "_max" });
+    @export(A.mapAdd, .{ .name = prefix ++ "_map_add" });
+    @export(A.mapSub, .{ .name = prefix ++ "_map_sub" });
+    @export(A.mapMul, .{ .name = prefix ++ "_map_mul" });
+    @export(A.mapScale, .{ .name = prefix ++ "_map_scale" });
+    @export(A.mapOffset, .{ .name = prefix ++ "_map_offset" });
+}
+
+comptime {
+    exportTypedArray(I64Array, "i64");
+    exportTypedArray(F64Array, "f64");
+    exportTypedArray(U8Array, "u8");
+}
+
+// ============================================================================
+// Contiguous Array Views
+// ============================================================================
+//
+// Element access for IdrisArray buffers (pointer + length, elements inline).
+// Idris holds the pointer as AnyPtr and reads elements in place, so bulk
+// numeric data crosses the boundary without per-element boxing or copies.
+// Bounds are checked on the Idris side (ZigFFI.Data.Array).
+
+/// Read an i64 element in place
+export fn idris2_view_i64_at(data: [*]const i64, index: usize) callconv(.C) i64 {
+    return data[index];
+}
+
+/// Read an f64 element in place
+export fn idris2_view_f64_at(data: [*]const f64, index: usize) callconv(.C) f64 {
+    return data[index];
+}
+
+/// Read a byte element in place
+export fn idris2_view_u8_at(data: [*]const u8, index: usize) callconv(.C) u8 {
+    return data[index];
+}
+
+/// Advance a view pointer by `offset` elements of `elem_size` bytes (slicing)
+export fn idris2_view_offset(data: ?*anyopaque, offset: usize, elem_size: usize) callconv(.C) ?*anyopaque {
+    const base = data orelse return null;
+    return @ptrFromInt(@intFromPtr(base) + offset * elem_size);
+}
+
 // ============================================================================
 // Type Conversion
 // ============================================================================
@@ -391,7 +665,7 @@ pub fn idrisEitherToCResult(either: idris_rts.IdrisEitherValue) CResult {
             // Cast left pointer to IdrisString if present
             if (either.left_ptr) |ptr| {
                 const str: *idris_rts.IdrisString = @ptrCast(@alignCast(ptr));
-                break :blk CResult.err(ErrorCode.UNKNOWN, types.fromIdrisString(str.*));
+                break :blk CResult.err(ErrorCode.UNKNOWN, types.fromIdrisString(str));
             }
             break :blk CResult.err(ErrorCode.UNKNOWN, "Unknown error");
         },
@@ -414,8 +688,14 @@ test "C string operations" {
     const cstr = idris2_string_from_cstr("hello");
     defer idris2_string_free(cstr);
 
-    try std.testing.expect(cstr.len == 5);
-    try std.testing.expectEqualStrings("hello", cstr.toSlice());
+    try std.testing.expect(idris2_string_len(cstr) == 5);
+    try std.testing.expectEqualStrings("hello", cstr.slice());
+
+    const text = "borrowed from the caller";
+    const borrowed = idris2_string_borrow_cstr(text);
+    defer idris2_string_free(borrowed);
+    try std.testing.expectEqual(@as(?[*]const u8, text), idris2_string_data(&borrowed));
+    try std.testing.expect(idris2_string_eq(borrowed, idris2_string_borrow_ptr(text, text.len)));
 }
 
 test "C option operations" {
@@ -434,6 +714,32 @@ test "C result operations" {
     try std.testing.expect(idris2_result_is_ok(ok));
     try std.testing.expect(!idris2_result_is_ok(err));
     try std.testing.expect(idris2_result_error_code(err) == ErrorCode.PARSE_ERROR);
+
+    const compact = idris2_result_err_id(ErrorCode.OVERFLOW, 0);
+    try std.testing.expect(!idris2_result_is_ok(compact));
+    try std.testing.expectEqualStrings("overflow", compact.error_msg.slice());
+
+    const by_zero = idris2_result_err_id(ErrorCode.DIVISION_BY_ZERO, 0);
+    try std.testing.expectEqualStrings("division_by_zero", by_zero.error_msg.slice());
+    const unlisted = idris2_result_err_id(9999, 0);
+    try std.testing.expectEqualStrings("unknown", unlisted.error_msg.slice());
+}
+
+test "typed array bulk operations" {
+    const data = F64Array.new(4) orelse return error.OutOfMemory;
+    defer F64Array.free(data, 4);
+
+    const input = [_]f64{ 1, 2, 3, 4 };
+    F64Array.copyIn(data, &input, input.len);
+    F64Array.mapScale(data, data, 2, input.len);
+
+    try std.testing.expectEqual(@as(f64, 20), F64Array.sum(data, 4));
+    try std.testing.expectEqual(@as(f64, 60), F64Array.dot(data, &input, 4));
+    try std.testing.expectEqual(@as(f64, 8), F64Array.max(data, 4));
+
+    var out: [4]f64 = undefined;
+    F64Array.copyOut(data, &out, out.len);
+    try std.testing.expectEqual(@as(f64, 2), out[0]);
 }
 
 test "ABI version" {
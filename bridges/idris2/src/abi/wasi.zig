@@ -40,53 +40,490 @@ pub const STDIN: Fd = 0;
 pub const STDOUT: Fd = 1;
 pub const STDERR: Fd = 2;
 
+/// Scatter/gather buffers as laid out by WASI (`iovec`/`ciovec`)
+pub const Iovec = std.posix.iovec;
+pub const ConstIovec = std.posix.iovec_const;
+
+/// Most iovecs passed in one call (wasi-libc's IOV_MAX)
+pub const max_iovecs = 1024;
+
+/// Host file for a descriptor when not running under WASI. POSIX hosts use
+/// the descriptor directly; Windows only maps the standard streams.
+fn hostFile(fd: Fd) !std.fs.File {
+    if (builtin.os.tag != .windows) return .{ .handle = fd };
+    return switch (fd) {
+        STDIN => std.io.getStdIn(),
+        STDOUT => std.io.getStdOut(),
+        STDERR => std.io.getStdErr(),
+        else => error.InvalidFd,
+    };
+}
+
 /// Write to a file descriptor
 pub fn write(fd: Fd, data: []const u8) !usize {
+    return writev(fd, &[_]ConstIovec{.{ .base = data.ptr, .len = data.len }});
+}
+
+/// Read from a file descriptor
+pub fn read(fd: Fd, buffer: []u8) !usize {
+    return readv(fd, &[_]Iovec{.{ .base = buffer.ptr, .len = buffer.len }});
+}
+
+/// Gather write: one fd_write over up to max_iovecs buffers. Returns the
+/// number of bytes written, which may be short.
+pub fn writev(fd: Fd, iovs: []const ConstIovec) !usize {
+    const batch = iovs[0..@min(iovs.len, max_iovecs)];
     if (builtin.os.tag == .wasi) {
-        const iov = std.os.wasi.iovec_t{
-            .base = data.ptr,
-            .len = data.len,
-        };
         var written: usize = undefined;
-        const result = std.os.wasi.fd_write(fd, &[_]std.os.wasi.iovec_t{iov}, 1, &written);
+        const result = std.os.wasi.fd_write(fd, batch.ptr, batch.len, &written);
         if (result != .SUCCESS) {
             return error.WasiError;
         }
         return written;
     } else {
-        // Fallback for non-WASI
-        const file = switch (fd) {
-            STDOUT => std.io.getStdOut(),
-            STDERR => std.io.getStdErr(),
-            else => return error.InvalidFd,
-        };
-        return file.write(data);
+        return (try hostFile(fd)).writev(batch);
     }
 }
 
-/// Read from a file descriptor
-pub fn read(fd: Fd, buffer: []u8) !usize {
+/// Scatter read: one fd_read filling the buffers in order
+pub fn readv(fd: Fd, iovs: []const Iovec) !usize {
+    const batch = iovs[0..@min(iovs.len, max_iovecs)];
     if (builtin.os.tag == .wasi) {
-        const iov = std.os.wasi.iovec_t{
-            .base = buffer.ptr,
-            .len = buffer.len,
-        };
         var bytes_read: usize = undefined;
-        const result = std.os.wasi.fd_read(fd, &[_]std.os.wasi.iovec_t{iov}, 1, &bytes_read);
+        const result = std.os.wasi.fd_read(fd, batch.ptr, batch.len, &bytes_read);
         if (result != .SUCCESS) {
             return error.WasiError;
         }
         return bytes_read;
     } else {
-        // Fallback for non-WASI
-        const file = switch (fd) {
-            STDIN => std.io.getStdIn(),
-            else => return error.InvalidFd,
-        };
-        return file.read(buffer);
+        return (try hostFile(fd)).readv(batch);
+    }
+}
+
+/// Write every byte of every buffer, retrying short writes. `iovs` is
+/// consumed: entries are advanced past what has been written.
+pub fn writevAll(fd: Fd, iovs: []ConstIovec) !void {
+    var i: usize = 0;
+    while (true) {
+        while (i < iovs.len and iovs[i].len == 0) i += 1;
+        if (i == iovs.len) return;
+
+        var n = try writev(fd, iovs[i..]);
+        if (n == 0) return error.WriteZero;
+        while (i < iovs.len and n >= iovs[i].len) : (i += 1) n -= iovs[i].len;
+        if (n > 0) {
+            iovs[i].base += n;
+            iovs[i].len -= n;
+        }
+    }
+}
+
+/// Write all of `data`
+pub fn writeAll(fd: Fd, data: []const u8) !void {
+    var iov = [_]ConstIovec{.{ .base = data.ptr, .len = data.len }};
+    return writevAll(fd, &iov);
+}
+
+/// Read into `buffer` at `offset` without moving the file position
+pub fn pread(fd: Fd, buffer: []u8, offset: u64) !usize {
+    if (builtin.os.tag == .wasi) {
+        const iov = [_]Iovec{.{ .base = buffer.ptr, .len = buffer.len }};
+        var bytes_read: usize = undefined;
+        const result = std.os.wasi.fd_pread(fd, &iov, iov.len, offset, &bytes_read);
+        if (result != .SUCCESS) {
+            return error.WasiError;
+        }
+        return bytes_read;
+    } else {
+        return (try hostFile(fd)).pread(buffer, offset);
+    }
+}
+
+/// Write `data` at `offset` without moving the file position
+pub fn pwrite(fd: Fd, data: []const u8, offset: u64) !usize {
+    if (builtin.os.tag == .wasi) {
+        const iov = [_]ConstIovec{.{ .base = data.ptr, .len = data.len }};
+        var written: usize = undefined;
+        const result = std.os.wasi.fd_pwrite(fd, &iov, iov.len, offset, &written);
+        if (result != .SUCCESS) {
+            return error.WasiError;
+        }
+        return written;
+    } else {
+        return (try hostFile(fd)).pwrite(data, offset);
     }
 }
 
+/// Write all of `data` at `offset`, retrying short writes
+pub fn pwriteAll(fd: Fd, data: []const u8, offset: u64) !void {
+    var done: usize = 0;
+    while (done < data.len) {
+        const n = try pwrite(fd, data[done..], offset + done);
+        if (n == 0) return error.WriteZero;
+        done += n;
+    }
+}
+
+// ============================================================================
+// Buffered Output
+// ============================================================================
+
+/// Collects small writes in a caller-supplied buffer and hands them to the
+/// host in as few fd_write calls as possible. Data that does not fit is
+/// sent together with the buffered bytes as one gather write instead of
+/// being copied. Nothing reaches the descriptor until the buffer fills or
+/// `flush` is called.
+pub const BufferedWriter = struct {
+    fd: Fd,
+    buffer: []u8,
+    end: usize = 0,
+    /// Number of fd_write calls issued
+    host_writes: u64 = 0,
+
+    const gather_batch = 64;
+
+    pub const Writer = std.io.Writer(*BufferedWriter, anyerror, writeFn);
+
+    pub fn init(fd: Fd, buffer: []u8) BufferedWriter {
+        return .{ .fd = fd, .buffer = buffer };
+    }
+
+    /// Bytes waiting to be flushed
+    pub fn buffered(self: *const BufferedWriter) []const u8 {
+        return self.buffer[0..self.end];
+    }
+
+    /// Append bytes, spilling to the host only when the buffer is full
+    pub fn write(self: *BufferedWriter, bytes: []const u8) !void {
+        return self.writeVectored(&[_][]const u8{bytes});
+    }
+
+    /// Append several slices. If they fit they are copied; otherwise the
+    /// buffered bytes and the slices go out as one gather write.
+    pub fn writeVectored(self: *BufferedWriter, slices: []const []const u8) !void {
+        var total: usize = 0;
+        for (slices) |s| total += s.len;
+
+        if (total <= self.buffer.len - self.end) {
+            for (slices) |s| {
+                @memcpy(self.buffer[self.end..][0..s.len], s);
+                self.end += s.len;
+            }
+            return;
+        }
+
+        var iovs: [gather_batch]ConstIovec = undefined;
+        var n: usize = 0;
+        if (self.end > 0) {
+            iovs[0] = .{ .base = self.buffer.ptr, .len = self.end };
+            n = 1;
+        }
+        for (slices) |s| {
+            if (s.len == 0) continue;
+            if (n == iovs.len) {
+                try self.send(iovs[0..n]);
+                n = 0;
+            }
+            iovs[n] = .{ .base = s.ptr, .len = s.len };
+            n += 1;
+        }
+        try self.send(iovs[0..n]);
+    }
+
+    /// Send everything buffered to the descriptor
+    pub fn flush(self: *BufferedWriter) !void {
+        if (self.end == 0) return;
+        var iov = [_]ConstIovec{.{ .base = self.buffer.ptr, .len = self.end }};
+        try self.send(&iov);
+    }
+
+    pub fn writer(self: *BufferedWriter) Writer {
+        return .{ .context = self };
+    }
+
+    fn writeFn(self: *BufferedWriter, bytes: []const u8) anyerror!usize {
+        try self.write(bytes);
+        return bytes.len;
+    }
+
+    /// Write `iovs` in full. The buffered prefix, if included, counts as
+    /// sent once this returns.
+    fn send(self: *BufferedWriter, iovs: []ConstIovec) !void {
+        self.host_writes += 1;
+        try writevAll(self.fd, iovs);
+        self.end = 0;
+    }
+};
+
+/// Buffer size for the shared stdout and stderr writers
+pub const stdio_buffer_size = 16 * 1024;
+
+/// Buffered stdout and stderr used by `wasi_print` and `wasi_eprint`.
+/// Switching streams flushes the other one first, so output keeps its
+/// relative order when both go to the same terminal. Call `flush` (or
+/// `wasi_flush` from the host) before handing control back for good;
+/// `exit` flushes automatically.
+pub const stdio = struct {
+    var mutex: std.Thread.Mutex = .{};
+    var out_buffer: [stdio_buffer_size]u8 = undefined;
+    var err_buffer: [stdio_buffer_size]u8 = undefined;
+    var out: BufferedWriter = .{ .fd = STDOUT, .buffer = &out_buffer };
+    var err: BufferedWriter = .{ .fd = STDERR, .buffer = &err_buffer };
+
+    /// Buffered write to stdout
+    pub fn print(bytes: []const u8) !void {
+        mutex.lock();
+        defer mutex.unlock();
+        try err.flush();
+        try out.write(bytes);
+    }
+
+    /// Buffered write to stderr
+    pub fn eprint(bytes: []const u8) !void {
+        mutex.lock();
+        defer mutex.unlock();
+        try out.flush();
+        try err.write(bytes);
+    }
+
+    /// Flush the buffer that belongs to `fd`, if any. Used before direct
+    /// writes to a standard stream so they do not overtake buffered data.
+    pub fn flushFd(fd: Fd) !void {
+        mutex.lock();
+        defer mutex.unlock();
+        switch (fd) {
+            STDOUT => try out.flush(),
+            STDERR => try err.flush(),
+            else => {},
+        }
+    }
+
+    /// Flush both streams
+    pub fn flush() !void {
+        mutex.lock();
+        defer mutex.unlock();
+        try out.flush();
+        try err.flush();
+    }
+};
+
+// ============================================================================
+// WASI Files
+// ============================================================================
+
+/// How `File.open` opens a path
+pub const OpenMode = enum(u8) {
+    /// Existing file, read only
+    read = 0,
+    /// Create or truncate, write only
+    write = 1,
+    /// Existing file, read and write
+    read_write = 2,
+};
+
+/// Origin for `File.seek`
+pub const Whence = enum(u8) { set = 0, cur = 1, end = 2 };
+
+/// Access pattern hints for `File.advise` (numbered as in WASI)
+pub const Advice = enum(u8) {
+    normal = 0,
+    sequential = 1,
+    random = 2,
+    will_need = 3,
+    dont_need = 4,
+    no_reuse = 5,
+};
+
+/// Directories the runtime granted (`wasmtime --dir`), loaded on first use
+const preopens = struct {
+    var mutex: std.Thread.Mutex = .{};
+    var list: ?std.fs.wasi.Preopens = null;
+
+    /// Pick the preopen with the longest name that contains `path` and
+    /// return it with the path relative to it. Relative paths resolve
+    /// against a "." preopen.
+    fn resolve(path: []const u8) !struct { dir: std.fs.Dir, sub_path: []const u8 } {
+        mutex.lock();
+        defer mutex.unlock();
+        if (list == null) list = try std.fs.wasi.preopensAlloc(memory.allocator);
+
+        var best: ?Fd = null;
+        var best_len: usize = 0;
+        var best_rest: []const u8 = undefined;
+        // The first three entries name stdin, stdout and stderr
+        for (list.?.names[3..], 3..) |name, fd| {
+            const rest = strip(name, path) orelse continue;
+            if (best == null or name.len > best_len) {
+                best = @intCast(fd);
+                best_len = name.len;
+                best_rest = rest;
+            }
+        }
+        const dir_fd = best orelse return error.NotPreopened;
+        return .{ .dir = .{ .fd = dir_fd }, .sub_path = best_rest };
+    }
+
+    /// `path` relative to preopen `name`, or null if outside it
+    fn strip(name: []const u8, path: []const u8) ?[]const u8 {
+        if (std.mem.eql(u8, name, ".") or std.mem.eql(u8, name, "./")) {
+            if (std.fs.path.isAbsolute(path)) return null;
+            return if (std.mem.startsWith(u8, path, "./")) path[2..] else path;
+        }
+        const base = std.mem.trimRight(u8, name, "/");
+        if (!std.mem.startsWith(u8, path, base)) return null;
+        const rest = path[base.len..];
+        if (rest.len > 0 and rest[0] != '/') return null;
+        const sub = std.mem.trimLeft(u8, rest, "/");
+        return if (sub.len == 0) "." else sub;
+    }
+};
+
+/// A file opened through the preopens under WASI, or relative to the
+/// working directory on native hosts
+pub const File = struct {
+    inner: std.fs.File,
+
+    pub fn open(path: []const u8, mode: OpenMode) !File {
+        var dir = std.fs.cwd();
+        var sub_path = path;
+        if (builtin.os.tag == .wasi) {
+            const r = try preopens.resolve(path);
+            dir = r.dir;
+            sub_path = r.sub_path;
+        }
+
+        const inner = switch (mode) {
+            .read => try dir.openFile(sub_path, .{}),
+            .write => try dir.createFile(sub_path, .{ .truncate = true }),
+            .read_write => try dir.openFile(sub_path, .{ .mode = .read_write }),
+        };
+        return .{ .inner = inner };
+    }
+
+    pub fn close(self: File) void {
+        self.inner.close();
+    }
+
+    pub fn fd(self: File) std.fs.File.Handle {
+        return self.inner.handle;
+    }
+
+    /// Read up to buffer.len bytes; 0 at end of file
+    pub fn read(self: File, buffer: []u8) !usize {
+        return self.inner.read(buffer);
+    }
+
+    pub fn writeAll(self: File, data: []const u8) !void {
+        return self.inner.writeAll(data);
+    }
+
+    /// Move the file position; returns the new absolute position
+    pub fn seek(self: File, offset: i64, whence: Whence) !u64 {
+        switch (whence) {
+            .set => try self.inner.seekTo(std.math.cast(u64, offset) orelse return error.InvalidOffset),
+            .cur => try self.inner.seekBy(offset),
+            .end => try self.inner.seekFromEnd(offset),
+        }
+        return self.inner.getPos();
+    }
+
+    pub fn size(self: File) !u64 {
+        return self.inner.getEndPos();
+    }
+
+    /// Hint the expected access pattern for a byte range (len 0 means to
+    /// the end of the file). Hosts without an equivalent ignore it.
+    pub fn advise(self: File, offset: u64, len: u64, advice: Advice) !void {
+        if (builtin.os.tag == .wasi) {
+            const result = std.os.wasi.fd_advise(self.inner.handle, offset, len, @enumFromInt(@intFromEnum(advice)));
+            if (result != .SUCCESS) {
+                return error.WasiError;
+            }
+        } else if (builtin.os.tag == .linux) {
+            const F = std.os.linux.POSIX_FADV;
+            const native: usize = switch (advice) {
+                .normal => F.NORMAL,
+                .sequential => F.SEQUENTIAL,
+                .random => F.RANDOM,
+                .will_need => F.WILLNEED,
+                .dont_need => F.DONTNEED,
+                .no_reuse => F.NOREUSE,
+            };
+            const rc = std.os.linux.fadvise(self.inner.handle, @intCast(offset), @intCast(len), native);
+            if (std.os.linux.E.init(rc) != .SUCCESS) return error.AdviseFailed;
+        }
+    }
+
+    /// Chunked reader over this file using `buffer` for every chunk
+    pub fn chunks(self: File, buffer: []u8) ChunkedReader {
+        return .{ .file = self, .buffer = buffer };
+    }
+};
+
+/// Streams a file through one fixed buffer. Each `next` refills the buffer
+/// from the current position, so a multi-gigabyte input never occupies
+/// more linear memory than the buffer itself.
+pub const ChunkedReader = struct {
+    file: File,
+    buffer: []u8,
+    len: usize = 0,
+
+    /// The next chunk, or null at end of file. Chunks are full-sized except
+    /// for the last one. The slice is overwritten by the following call.
+    pub fn next(self: *ChunkedReader) !?[]const u8 {
+        self.len = 0;
+        while (self.len < self.buffer.len) {
+            const n = try self.file.read(self.buffer[self.len..]);
+            if (n == 0) break;
+            self.len += n;
+        }
+        return if (self.len == 0) null else self.buffer[0..self.len];
+    }
+};
+
+/// Open files handed out to Idris and the host as small integer handles
+const open_files = struct {
+    const max = 64;
+
+    const Slot = struct {
+        file: File,
+        reader: ?ChunkedReader = null,
+    };
+
+    var mutex: std.Thread.Mutex = .{};
+    var slots: [max]?Slot = [_]?Slot{null} ** max;
+
+    fn add(file: File) !i32 {
+        mutex.lock();
+        defer mutex.unlock();
+        for (&slots, 0..) |*slot, i| {
+            if (slot.* == null) {
+                slot.* = .{ .file = file };
+                return @intCast(i);
+            }
+        }
+        return error.TooManyOpenFiles;
+    }
+
+    /// Slot for a handle. Each handle is meant to be used from one thread
+    /// at a time; the table lock only guards open and close.
+    fn get(handle: i32) ?*Slot {
+        if (handle < 0 or handle >= max) return null;
+        const slot = &slots[@intCast(handle)];
+        return if (slot.* != null) &slot.*.? else null;
+    }
+
+    fn remove(handle: i32) bool {
+        mutex.lock();
+        defer mutex.unlock();
+        const slot = get(handle) orelse return false;
+        if (slot.reader) |r| memory.allocator.free(r.buffer);
+        slot.file.close();
+        slots[@intCast(handle)] = null;
+        return true;
+    }
+};
+
 // ============================================================================
 // WASI Environment
 // ============================================================================
@@ -197,6 +634,7 @@ pub fn getRealTime() !u64 {
 
 /// Exit the process
 pub fn exit(code: u32) noreturn {
+    stdio.flush() catch {};
     if (builtin.os.tag == .wasi) {
         std.os.wasi.proc_exit(code);
     } else {
@@ -214,18 +652,44 @@ export fn wasi_init() callconv(.C) i32 {
     return 0;
 }
 
-/// Write to stdout
+/// Write to stdout (buffered)
 export fn wasi_print(ptr: [*]const u8, len: usize) callconv(.C) i32 {
-    write(STDOUT, ptr[0..len]) catch return -1;
+    stdio.print(ptr[0..len]) catch return -1;
     return 0;
 }
 
-/// Write to stderr
+/// Write to stderr (buffered)
 export fn wasi_eprint(ptr: [*]const u8, len: usize) callconv(.C) i32 {
-    write(STDERR, ptr[0..len]) catch return -1;
+    stdio.eprint(ptr[0..len]) catch return -1;
     return 0;
 }
 
+/// Flush buffered stdout and stderr
+export fn wasi_flush() callconv(.C) i32 {
+    stdio.flush() catch return -1;
+    return 0;
+}
+
+/// Gather write of `count` iovecs in one host call. Returns bytes written
+/// (possibly short) or -1.
+export fn wasi_writev(fd: Fd, iovs: [*]const ConstIovec, count: usize) callconv(.C) i64 {
+    stdio.flushFd(fd) catch return -1;
+    const n = writev(fd, iovs[0..count]) catch return -1;
+    return @intCast(n);
+}
+
+/// Positional read; returns bytes read or -1
+export fn wasi_pread(fd: Fd, ptr: [*]u8, len: usize, offset: u64) callconv(.C) i64 {
+    const n = pread(fd, ptr[0..len], offset) catch return -1;
+    return @intCast(n);
+}
+
+/// Positional write; returns bytes written or -1
+export fn wasi_pwrite(fd: Fd, ptr: [*]const u8, len: usize, offset: u64) callconv(.C) i64 {
+    const n = pwrite(fd, ptr[0..len], offset) catch return -1;
+    return @intCast(n);
+}
+
 /// Get random bytes
 export fn wasi_random(ptr: [*]u8, len: usize) callconv(.C) i32 {
     getRandomBytes(ptr[0..len]) catch return -1;
@@ -247,6 +711,82 @@ export fn wasi_exit(code: u32) callconv(.C) noreturn {
     exit(code);
 }
 
+/// Open a file (NUL-terminated path, OpenMode). Under WASI the path must
+/// lie inside a preopened directory. Returns a handle or -1.
+export fn wasi_file_open(path: [*:0]const u8, mode: u8) callconv(.C) i32 {
+    const m = std.meta.intToEnum(OpenMode, mode) catch return -1;
+    const file = File.open(std.mem.span(path), m) catch return -1;
+    return open_files.add(file) catch {
+        file.close();
+        return -1;
+    };
+}
+
+/// Close a handle (and free its chunk buffer)
+export fn wasi_file_close(handle: i32) callconv(.C) i32 {
+    return if (open_files.remove(handle)) 0 else -1;
+}
+
+/// Read into a caller buffer; returns bytes read, 0 at EOF, or -1
+export fn wasi_file_read(handle: i32, ptr: [*]u8, len: usize) callconv(.C) i64 {
+    const slot = open_files.get(handle) orelse return -1;
+    const n = slot.file.read(ptr[0..len]) catch return -1;
+    return @intCast(n);
+}
+
+/// Seek (Whence); returns the new position or -1
+export fn wasi_file_seek(handle: i32, offset: i64, whence: u8) callconv(.C) i64 {
+    const slot = open_files.get(handle) orelse return -1;
+    const w = std.meta.intToEnum(Whence, whence) catch return -1;
+    const pos = slot.file.seek(offset, w) catch return -1;
+    return @intCast(pos);
+}
+
+/// File size in bytes or -1
+export fn wasi_file_size(handle: i32) callconv(.C) i64 {
+    const slot = open_files.get(handle) orelse return -1;
+    const n = slot.file.size() catch return -1;
+    return @intCast(n);
+}
+
+/// Access pattern hint (Advice) for a byte range
+export fn wasi_file_advise(handle: i32, offset: u64, len: u64, advice: u8) callconv(.C) i32 {
+    const slot = open_files.get(handle) orelse return -1;
+    const a = std.meta.intToEnum(Advice, advice) catch return -1;
+    slot.file.advise(offset, len, a) catch return -1;
+    return 0;
+}
+
+/// Attach a chunk buffer of `chunk_size` bytes to a handle and mark the
+/// file as read sequentially. Chunks are then pulled with
+/// wasi_file_next_chunk and read in place through wasi_file_chunk.
+/// `chunk_size` is u64 rather than usize so the signature is the same on
+/// wasm32 and native hosts (Idris passes Bits64).
+export fn wasi_file_reader(handle: i32, chunk_size: u64) callconv(.C) i32 {
+    const slot = open_files.get(handle) orelse return -1;
+    const len = std.math.cast(usize, chunk_size) orelse return -1;
+    if (slot.reader != null or len == 0) return -1;
+    const buffer = memory.allocator.alloc(u8, len) catch return -1;
+    slot.reader = slot.file.chunks(buffer);
+    slot.file.advise(0, 0, .sequential) catch {};
+    return 0;
+}
+
+/// Refill the chunk buffer; returns its length, 0 at EOF, or -1
+export fn wasi_file_next_chunk(handle: i32) callconv(.C) i64 {
+    const slot = open_files.get(handle) orelse return -1;
+    const reader = if (slot.reader) |*r| r else return -1;
+    const chunk = reader.next() catch return -1;
+    return @intCast(if (chunk) |c| c.len else 0);
+}
+
+/// Start of the chunk buffer (valid until the next refill or close)
+export fn wasi_file_chunk(handle: i32) callconv(.C) ?[*]const u8 {
+    const slot = open_files.get(handle) orelse return null;
+    const reader = slot.reader orelse return null;
+    return reader.buffer.ptr;
+}
+
 // ============================================================================
 // Idris Integration
 // ============================================================================
@@ -263,7 +803,7 @@ pub fn wasiResultToIdris(comptime T: type, result: anyerror!T) idris_rts.IdrisEi
         const msg = @errorName(err);
         return .{
             .tag = .left,
-            .left = .{ .string = types.toIdrisString(msg) },
+            .left = .{ .string = types.borrowIdrisString(msg) },
             .right = undefined,
         };
     }
@@ -292,6 +832,74 @@ test "random bytes" {
     try std.testing.expect(!std.mem.eql(u8, &buf1, &buf2));
 }
 
+test "buffered writer batches into gather writes" {
+    if (builtin.os.tag == .wasi or builtin.os.tag == .windows) return error.SkipZigTest;
+
+    const fds = try std.posix.pipe();
+    defer std.posix.close(fds[0]);
+    defer std.posix.close(fds[1]);
+
+    var buf: [64]u8 = undefined;
+    var bw = BufferedWriter.init(fds[1], &buf);
+
+    for (0..10) |_| try bw.write("line\n");
+    try std.testing.expectEqual(@as(u64, 0), bw.host_writes);
+    try std.testing.expectEqual(@as(usize, 50), bw.buffered().len);
+
+    // Does not fit: buffered bytes and both slices leave in one call
+    try bw.writeVectored(&.{ "a" ** 20, "b" ** 20 });
+    try std.testing.expectEqual(@as(u64, 1), bw.host_writes);
+    try std.testing.expectEqual(@as(usize, 0), bw.buffered().len);
+
+    try bw.writer().print("{d}", .{42});
+    try bw.flush();
+    try std.testing.expectEqual(@as(u64, 2), bw.host_writes);
+
+    var out: [128]u8 = undefined;
+    const n = try read(fds[0], &out);
+    try std.testing.expectEqualStrings("line\n" ** 10 ++ "a" ** 20 ++ "b" ** 20 ++ "42", out[0..n]);
+}
+
+test "chunked reader streams through one buffer" {
+    if (builtin.os.tag == .wasi) return error.SkipZigTest;
+
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    const data = "0123456789" ** 25;
+    try tmp.dir.writeFile(.{ .sub_path = "input.bin", .data = data });
+
+    const file = File{ .inner = try tmp.dir.openFile("input.bin", .{}) };
+    defer file.close();
+    try std.testing.expectEqual(@as(u64, data.len), try file.size());
+    try file.advise(0, 0, .sequential);
+
+    var buf: [64]u8 = undefined;
+    var reader = file.chunks(&buf);
+    var total: usize = 0;
+    var count: usize = 0;
+    while (try reader.next()) |chunk| {
+        try std.testing.expectEqualStrings(data[total..][0..chunk.len], chunk);
+        try std.testing.expectEqual(@intFromPtr(&buf), @intFromPtr(chunk.ptr));
+        total += chunk.len;
+        count += 1;
+    }
+    try std.testing.expectEqual(data.len, total);
+    try std.testing.expectEqual(@as(usize, 4), count);
+
+    try std.testing.expectEqual(@as(u64, 240), try file.seek(-10, .end));
+    try std.testing.expectEqual(@as(usize, 10), try file.read(&buf));
+}
+
+test "preopen path resolution" {
+    try std.testing.expectEqualStrings("in/a.txt", preopens.strip("/data", "/data/in/a.txt").?);
+    try std.testing.expectEqualStrings("a.txt", preopens.strip("/data/", "/data/a.txt").?);
+    try std.testing.expectEqualStrings(".", preopens.strip("/data", "/data").?);
+    try std.testing.expect(preopens.strip("/data", "/database/x") == null);
+    try std.testing.expectEqualStrings("x/y", preopens.strip(".", "./x/y").?);
+    try std.testing.expect(preopens.strip(".", "/x") == null);
+    try std.testing.expectEqualStrings("etc/hosts", preopens.strip("/", "/etc/hosts").?);
+}
+
 test "monotonic time increases" {
     const t1 = try getMonotonicTime();
     std.time.sleep(1_000_000); // 1ms
@@ -12,20 +12,73 @@ const builtin = @import("builtin");
 const memory = @import("../memory.zig");
 const types = @import("../types.zig");
 const idris_rts = @import("../idris_rts.zig");
+const bulk = @import("../bulk.zig");
 
 // ============================================================================
 // WASM Memory Management
 // ============================================================================
 
+/// WebAssembly page size (memory.grow granularity)
+pub const wasm_page_size: usize = 64 * 1024;
+
+/// Start of the free heap, placed by wasm-ld after data and stack
+extern var __heap_base: u8;
+
 /// WASM linear memory allocator
-/// Uses a simple bump allocator for WASM's linear memory model
+///
+/// Two modes over the same [heap_base, heap_end) region:
+/// - bump: allocation moves a pointer; free is a no-op and only reset
+///   reclaims memory. Cheapest for short-lived, reset-per-frame usage.
+/// - free_list: blocks carry a boundary-tag header (size + previous size)
+///   and freed blocks go on size-segregated lists. Neighbouring free blocks
+///   are coalesced, and a block next to the untouched tail is returned to
+///   it. When the heap runs out and ends at the end of linear memory, it
+///   grows with memory.grow.
 pub const WasmAllocator = struct {
     heap_base: usize,
     heap_end: usize,
+    /// Bump pointer; in free_list mode, the start of the untouched tail
     current: usize,
+    mode: Mode = .bump,
+    /// Heads of the free lists by size class (block addresses, 0 = empty)
+    bins: [bin_count]usize = [_]usize{0} ** bin_count,
+    /// Bytes held in free lists
+    free_bytes: usize = 0,
+    /// Size of the block just below `current` (0 if none)
+    top_prev_size: usize = 0,
+    /// The heap ends at the end of linear memory and may grow
+    can_grow: bool = false,
 
     const Self = @This();
 
+    pub const Mode = enum(u32) {
+        bump = 0,
+        free_list = 1,
+    };
+
+    /// Largest alignment served in free_list mode
+    pub const max_alignment: usize = 16;
+
+    const Header = extern struct {
+        /// Block size including the header; low bit set while allocated
+        size: usize,
+        /// Size of the physically previous block (0 for the first block)
+        prev_size: usize,
+    };
+    const header_size: usize = max_alignment;
+    const used_bit: usize = 1;
+
+    /// Links stored in the payload of a free block
+    const FreeLinks = extern struct {
+        next: usize,
+        prev: usize,
+    };
+
+    const min_block_shift = 5;
+    const min_block: usize = 1 << min_block_shift;
+    const bin_count = 26;
+
+    /// Bump allocator over [heap_base, heap_base + heap_size)
     pub fn init(heap_base: usize, heap_size: usize) Self {
         return .{
             .heap_base = heap_base,
@@ -34,7 +87,24 @@ pub const WasmAllocator = struct {
         };
     }
 
+    /// Allocator in the given mode. In free_list mode the region is trimmed
+    /// to max_alignment boundaries.
+    pub fn initMode(heap_base: usize, heap_size: usize, mode: Mode) Self {
+        if (mode == .bump) return init(heap_base, heap_size);
+
+        const base = std.mem.alignForward(usize, heap_base, max_alignment);
+        const end = std.mem.alignBackward(usize, heap_base + heap_size, max_alignment);
+        var self = init(base, if (end > base) end - base else 0);
+        self.mode = mode;
+        return self;
+    }
+
     pub fn alloc(self: *Self, size: usize, alignment: usize) ?[*]u8 {
+        if (self.mode == .free_list) {
+            const addr = self.allocBlock(size, alignment) orelse return null;
+            return @ptrFromInt(addr + header_size);
+        }
+
         const aligned_current = std.mem.alignForward(usize, self.current, alignment);
         const new_current = aligned_current + size;
 
@@ -46,24 +116,186 @@ pub const WasmAllocator = struct {
         return @ptrFromInt(aligned_current);
     }
 
+    /// Release a block from alloc (no-op in bump mode)
+    pub fn free(self: *Self, ptr: [*]u8) void {
+        if (self.mode != .free_list) return;
+        self.freeBlock(@intFromPtr(ptr) - header_size);
+    }
+
     pub fn reset(self: *Self) void {
         self.current = self.heap_base;
+        self.bins = [_]usize{0} ** bin_count;
+        self.free_bytes = 0;
+        self.top_prev_size = 0;
     }
 
-    /// Get remaining free memory
+    /// Get remaining free memory (untouched tail plus free lists)
     pub fn freeSpace(self: *const Self) usize {
-        return self.heap_end - self.current;
+        return self.heap_end - self.current + self.free_bytes;
+    }
+
+    fn header(addr: usize) *Header {
+        return @ptrFromInt(addr);
+    }
+
+    fn links(addr: usize) *FreeLinks {
+        return @ptrFromInt(addr + header_size);
+    }
+
+    fn blockSize(addr: usize) usize {
+        return header(addr).size & ~used_bit;
+    }
+
+    fn isUsed(addr: usize) bool {
+        return header(addr).size & used_bit != 0;
+    }
+
+    fn binIndex(size: usize) usize {
+        return @min(std.math.log2_int(usize, size) - min_block_shift, bin_count - 1);
+    }
+
+    fn pushFree(self: *Self, addr: usize, size: usize) void {
+        header(addr).size = size;
+        const bin = binIndex(size);
+        const l = links(addr);
+        l.prev = 0;
+        l.next = self.bins[bin];
+        if (l.next != 0) links(l.next).prev = addr;
+        self.bins[bin] = addr;
+        self.free_bytes += size;
+    }
+
+    fn unlinkFree(self: *Self, addr: usize) void {
+        const size = blockSize(addr);
+        const l = links(addr);
+        if (l.prev != 0) {
+            links(l.prev).next = l.next;
+        } else {
+            self.bins[binIndex(size)] = l.next;
+        }
+        if (l.next != 0) links(l.next).prev = l.prev;
+        self.free_bytes -= size;
+    }
+
+    /// Record `size` as the previous-block size of whatever follows `addr`
+    fn linkNext(self: *Self, addr: usize, size: usize) void {
+        const next = addr + size;
+        if (next == self.current) {
+            self.top_prev_size = size;
+        } else {
+            header(next).prev_size = size;
+        }
+    }
+
+    fn allocBlock(self: *Self, size: usize, alignment: usize) ?usize {
+        if (alignment > max_alignment) return null;
+        if (size > self.heap_end) return null;
+        const need = @max(min_block, std.mem.alignForward(usize, size + header_size, max_alignment));
+
+        // Free lists: first fit, starting at the request's own class
+        var bin = binIndex(need);
+        while (bin < bin_count) : (bin += 1) {
+            var addr = self.bins[bin];
+            while (addr != 0) : (addr = links(addr).next) {
+                if (blockSize(addr) < need) continue;
+                self.unlinkFree(addr);
+                self.split(addr, need);
+                return addr;
+            }
+        }
+
+        // Untouched tail, growing linear memory if needed
+        if (self.heap_end - self.current < need and !self.grow(need)) return null;
+
+        const addr = self.current;
+        header(addr).* = .{ .size = need | used_bit, .prev_size = self.top_prev_size };
+        self.current += need;
+        self.top_prev_size = need;
+        return addr;
+    }
+
+    /// Mark a free-list block used, returning any usable remainder
+    fn split(self: *Self, addr: usize, need: usize) void {
+        const total = blockSize(addr);
+        if (total - need < min_block) {
+            header(addr).size = total | used_bit;
+            return;
+        }
+
+        header(addr).size = need | used_bit;
+        const rest = addr + need;
+        header(rest).prev_size = need;
+        self.pushFree(rest, total - need);
+        self.linkNext(rest, total - need);
+    }
+
+    fn freeBlock(self: *Self, addr: usize) void {
+        std.debug.assert(isUsed(addr));
+        var start = addr;
+        var size = blockSize(addr);
+
+        const next = addr + size;
+        if (next != self.current and !isUsed(next)) {
+            const next_size = blockSize(next);
+            self.unlinkFree(next);
+            size += next_size;
+        }
+
+        const prev_size = header(addr).prev_size;
+        if (prev_size != 0 and !isUsed(addr - prev_size)) {
+            start = addr - prev_size;
+            self.unlinkFree(start);
+            size += prev_size;
+        }
+
+        // Adjacent to the tail: give it back rather than listing it
+        if (start + size == self.current) {
+            self.current = start;
+            self.top_prev_size = header(start).prev_size;
+            return;
+        }
+
+        self.pushFree(start, size);
+        self.linkNext(start, size);
+    }
+
+    /// Extend heap_end with memory.grow so at least `need` tail bytes exist
+    fn grow(self: *Self, need: usize) bool {
+        if (comptime builtin.target.cpu.arch != .wasm32) return false;
+        if (!self.can_grow) return false;
+
+        const missing = need - (self.heap_end - self.current);
+        const pages = std.math.divCeil(usize, missing, wasm_page_size) catch return false;
+        const old_pages = @wasmMemoryGrow(0, pages);
+        if (old_pages < 0) return false;
+
+        // Only growth that continues this heap is usable
+        if (@as(usize, @intCast(old_pages)) * wasm_page_size != self.heap_end) return false;
+        self.heap_end += pages * wasm_page_size;
+        return true;
     }
 };
 
 /// Global WASM allocator instance
 var wasm_allocator: ?WasmAllocator = null;
 
-/// Initialize WASM allocator with given heap bounds
+/// Initialize WASM allocator with given heap bounds (bump mode)
 pub fn initWasmHeap(heap_base: usize, heap_size: usize) void {
     wasm_allocator = WasmAllocator.init(heap_base, heap_size);
 }
 
+/// Default heap start: __heap_base on wasm32, the old fixed base elsewhere
+fn defaultHeapBase() usize {
+    if (comptime builtin.target.cpu.arch == .wasm32) return @intFromPtr(&__heap_base);
+    return 0x10000;
+}
+
+/// Current end of linear memory (0 when not running as wasm32)
+fn linearMemoryEnd() usize {
+    if (comptime builtin.target.cpu.arch == .wasm32) return @wasmMemorySize(0) * wasm_page_size;
+    return 0;
+}
+
 // ============================================================================
 // JavaScript Interop
 // ============================================================================
@@ -126,15 +358,236 @@ pub fn fromJsString(ptr: [*]const u8, len: usize) []const u8 {
     return ptr[0..len];
 }
 
+// ============================================================================
+// Shared Ring Buffers
+// ============================================================================
+//
+// Bulk data moves between JS and WASM through two single-producer,
+// single-consumer rings in linear memory: requests (JS -> WASM) and
+// responses (WASM -> JS). The host reads and writes them directly through a
+// DataView, so one wasm_ring_process call handles a whole batch of records
+// with no per-record allocation or copy.
+//
+// Ring layout (all fields little-endian u32):
+//
+//   +0  magic      "IRNG" (0x474E5249)
+//   +4  capacity   data bytes, a power of two
+//   +8  head       consumer position (free-running; offset = head & (capacity-1))
+//   +12 tail       producer position (free-running)
+//   +16 records_in / +20 records_out / +24 dropped / +28 reserved
+//   +32 data
+//
+// Records are 8-byte aligned: { len: u32, tag: u32, payload[len] }. A record
+// never wraps: when it does not fit before the end of the data area, the
+// producer writes a padding record (tag 0xFFFFFFFF) and starts again at 0.
+// The producer only writes `tail`, the consumer only writes `head`.
+
+pub const ring_magic: u32 = 0x474E5249;
+pub const ring_pad_tag: u32 = 0xFFFFFFFF;
+
+pub const RingHeader = extern struct {
+    magic: u32,
+    capacity: u32,
+    head: u32,
+    tail: u32,
+    records_in: u32,
+    records_out: u32,
+    dropped: u32,
+    _reserved: u32,
+};
+
+const RecordHeader = extern struct {
+    len: u32,
+    tag: u32,
+};
+
+const record_align: u32 = @sizeOf(RecordHeader);
+
+/// A record read from a ring; `payload` points into the ring and is valid
+/// until the record is consumed
+pub const RingRecord = struct {
+    tag: u32,
+    payload: []const u8,
+};
+
+/// Space reserved in a ring for a record; fill `payload`, then commit
+pub const RingReservation = struct {
+    tag: u32,
+    payload: []u8,
+    new_tail: u32,
+};
+
+pub const SharedRing = struct {
+    header: *RingHeader,
+
+    /// Lay out a ring over `region` (header + largest power-of-two data area)
+    pub fn init(region: []align(8) u8) ?SharedRing {
+        if (region.len < @sizeOf(RingHeader) + 2 * record_align) return null;
+        const avail = @min(region.len - @sizeOf(RingHeader), std.math.maxInt(u32) / 2 + 1);
+        const capacity: u32 = @intCast(std.math.floorPowerOfTwo(usize, avail));
+
+        const header: *RingHeader = @ptrCast(region.ptr);
+        header.* = .{
+            .magic = ring_magic,
+            .capacity = capacity,
+            .head = 0,
+            .tail = 0,
+            .records_in = 0,
+            .records_out = 0,
+            .dropped = 0,
+            ._reserved = 0,
+        };
+        return .{ .header = header };
+    }
+
+    /// Attach to an existing ring header
+    pub fn attach(addr: usize) ?SharedRing {
+        if (addr == 0) return null;
+        const header: *RingHeader = @ptrFromInt(addr);
+        if (header.magic != ring_magic) return null;
+        return .{ .header = header };
+    }
+
+    fn data(self: SharedRing) [*]u8 {
+        return @as([*]u8, @ptrCast(self.header)) + @sizeOf(RingHeader);
+    }
+
+    fn recordAt(self: SharedRing, pos: u32) *align(1) RecordHeader {
+        return @ptrCast(self.data() + (pos & (self.header.capacity - 1)));
+    }
+
+    /// Reserve space for a record of `len` bytes; null if the ring is full
+    pub fn reserve(self: SharedRing, tag: u32, len: usize) ?RingReservation {
+        const capacity = self.header.capacity;
+        if (len > capacity) return null;
+        const size: u32 = @intCast(std.mem.alignForward(usize, @sizeOf(RecordHeader) + len, record_align));
+
+        var tail = @atomicLoad(u32, &self.header.tail, .monotonic);
+        const head = @atomicLoad(u32, &self.header.head, .acquire);
+        const contiguous = capacity - (tail & (capacity - 1));
+        const needed = if (contiguous < size) contiguous + size else size;
+
+        if (capacity - (tail -% head) < needed) {
+            self.header.dropped +%= 1;
+            return null;
+        }
+
+        if (contiguous < size) {
+            // Pad to the end so the record stays contiguous
+            self.recordAt(tail).* = .{ .len = contiguous - @sizeOf(RecordHeader), .tag = ring_pad_tag };
+            tail +%= contiguous;
+        }
+
+        const rec = self.recordAt(tail);
+        rec.* = .{ .len = @intCast(len), .tag = tag };
+        const payload = (@as([*]u8, @ptrCast(rec)) + @sizeOf(RecordHeader))[0..len];
+        return .{ .tag = tag, .payload = payload, .new_tail = tail +% size };
+    }
+
+    /// Publish a reserved record to the consumer
+    pub fn commit(self: SharedRing, reservation: RingReservation) void {
+        self.header.records_in +%= 1;
+        @atomicStore(u32, &self.header.tail, reservation.new_tail, .release);
+    }
+
+    /// Copy a record into the ring; false if it is full
+    pub fn push(self: SharedRing, tag: u32, payload: []const u8) bool {
+        const reservation = self.reserve(tag, payload.len) orelse return false;
+        @memcpy(reservation.payload, payload);
+        self.commit(reservation);
+        return true;
+    }
+
+    /// Next record without consuming it, or null if the ring is empty
+    pub fn peek(self: SharedRing) ?RingRecord {
+        while (true) {
+            const head = @atomicLoad(u32, &self.header.head, .monotonic);
+            const tail = @atomicLoad(u32, &self.header.tail, .acquire);
+            if (head == tail) return null;
+
+            const rec = self.recordAt(head);
+            if (rec.tag == ring_pad_tag) {
+                @atomicStore(u32, &self.header.head, head +% @sizeOf(RecordHeader) +% rec.len, .release);
+                continue;
+            }
+
+            const payload = (@as([*]const u8, @ptrCast(rec)) + @sizeOf(RecordHeader))[0..rec.len];
+            return .{ .tag = rec.tag, .payload = payload };
+        }
+    }
+
+    /// Consume the record returned by the last peek
+    pub fn consume(self: SharedRing, record: RingRecord) void {
+        const size: u32 = @intCast(std.mem.alignForward(usize, @sizeOf(RecordHeader) + record.payload.len, record_align));
+        const head = @atomicLoad(u32, &self.header.head, .monotonic);
+        self.header.records_out +%= 1;
+        @atomicStore(u32, &self.header.head, head +% size, .release);
+    }
+
+    /// Bytes waiting to be consumed (including padding)
+    pub fn pending(self: SharedRing) u32 {
+        return @atomicLoad(u32, &self.header.tail, .acquire) -% @atomicLoad(u32, &self.header.head, .acquire);
+    }
+};
+
+/// Handles one request record; may push results to `response`
+pub const RingHandler = *const fn (tag: u32, payload: []const u8, response: SharedRing) void;
+
+var request_ring: ?SharedRing = null;
+var response_ring: ?SharedRing = null;
+var ring_handler: ?RingHandler = null;
+
+/// Set the handler that wasm_ring_process dispatches request records to
+pub fn setRingHandler(handler: ?RingHandler) void {
+    ring_handler = handler;
+}
+
+/// Consume up to `max_records` request records, dispatching each to
+/// `handler`. Returns the number of records processed.
+pub fn processRing(request: SharedRing, response: SharedRing, handler: RingHandler, max_records: u32) u32 {
+    var processed: u32 = 0;
+    while (processed < max_records) : (processed += 1) {
+        const record = request.peek() orelse break;
+        handler(record.tag, record.payload, response);
+        request.consume(record);
+    }
+    return processed;
+}
+
 // ============================================================================
 // WASM Exports
 // ============================================================================
 
-/// Initialize WASM module
+/// Initialize WASM module with a free-list heap from __heap_base to the
+/// end of linear memory, growing on demand
 export fn wasm_init() callconv(.C) i32 {
-    // Initialize with 1MB heap by default
-    // In real usage, this would be configured by the host
-    initWasmHeap(0x10000, 1024 * 1024);
+    return wasm_init_heap(0, 0, @intFromEnum(WasmAllocator.Mode.free_list));
+}
+
+/// Configure the heap. `base` 0 means __heap_base; `size` 0 means up to the
+/// current end of linear memory (1 MiB when not running as wasm32).
+/// `mode`: 0 = bump, 1 = free list. The free-list heap grows with
+/// memory.grow only if it ends at the end of linear memory.
+/// Returns 0, or -1 for an invalid mode or empty region.
+export fn wasm_init_heap(base: usize, size: usize, mode: u32) callconv(.C) i32 {
+    const heap_mode = std.meta.intToEnum(WasmAllocator.Mode, mode) catch return -1;
+    const heap_base = if (base != 0) base else defaultHeapBase();
+    const mem_end = linearMemoryEnd();
+
+    const heap_size = if (size != 0)
+        size
+    else if (mem_end > heap_base)
+        mem_end - heap_base
+    else
+        1024 * 1024;
+
+    var heap = WasmAllocator.initMode(heap_base, heap_size, heap_mode);
+    if (heap.heap_end <= heap.heap_base) return -1;
+    heap.can_grow = heap_mode == .free_list and heap.heap_end == mem_end;
+    wasm_allocator = heap;
+    // Rings lived in the old heap
+    request_ring = null;
+    response_ring = null;
     return 0;
 }
 
@@ -148,18 +601,73 @@ export fn wasm_alloc(size: usize) callconv(.C) usize {
     return 0;
 }
 
-/// Free memory (for JS to call)
+/// Free memory (for JS to call). Returns the block to the free lists in
+/// free-list mode; a no-op in bump mode, where only reset reclaims memory.
 export fn wasm_free(ptr: usize) callconv(.C) void {
-    // In bump allocator, individual frees are no-ops
-    // Memory is reclaimed on reset
-    _ = ptr;
+    if (ptr == 0) return;
+    if (wasm_allocator) |*alloc| {
+        alloc.free(@ptrFromInt(ptr));
+    }
+}
+
+/// Allocate the request and response rings from the WASM heap, releasing
+/// any rings from an earlier call first (their addresses become invalid).
+/// Sizes are rounded down to a power of two. Returns the request ring
+/// address (response: wasm_ring_response), or 0 on failure.
+export fn wasm_ring_init(request_bytes: u32, response_bytes: u32) callconv(.C) usize {
+    const heap = if (wasm_allocator) |*a| a else return 0;
+    for ([_]*?SharedRing{ &request_ring, &response_ring }) |ring| {
+        if (ring.*) |r| heap.free(@ptrCast(r.header));
+        ring.* = null;
+    }
+
+    const req_len = @sizeOf(RingHeader) + @as(usize, request_bytes);
+    const resp_len = @sizeOf(RingHeader) + @as(usize, response_bytes);
+
+    const req_mem = heap.alloc(req_len, 8) orelse return 0;
+    const resp_mem = heap.alloc(resp_len, 8) orelse {
+        heap.free(req_mem);
+        return 0;
+    };
+
+    const request = SharedRing.init(@alignCast(req_mem[0..req_len]));
+    const response = SharedRing.init(@alignCast(resp_mem[0..resp_len]));
+    if (request == null or response == null) {
+        heap.free(req_mem);
+        heap.free(resp_mem);
+        return 0;
+    }
+    request_ring = request;
+    response_ring = response;
+    return @intFromPtr(request.?.header);
+}
+
+/// Address of the request ring header (0 before wasm_ring_init)
+export fn wasm_ring_request() callconv(.C) usize {
+    return if (request_ring) |r| @intFromPtr(r.header) else 0;
+}
+
+/// Address of the response ring header (0 before wasm_ring_init)
+export fn wasm_ring_response() callconv(.C) usize {
+    return if (response_ring) |r| @intFromPtr(r.header) else 0;
+}
+
+/// Process up to `max_records` queued requests in one call.
+/// Returns the number processed.
+export fn wasm_ring_process(max_records: u32) callconv(.C) u32 {
+    const request = request_ring orelse return 0;
+    const response = response_ring orelse return 0;
+    const handler = ring_handler orelse return 0;
+    return processRing(request, response, handler, max_records);
 }
 
-/// Reset allocator (free all memory)
+/// Reset allocator (free all memory, including the rings)
 export fn wasm_reset() callconv(.C) void {
     if (wasm_allocator) |*alloc| {
         alloc.reset();
     }
+    request_ring = null;
+    response_ring = null;
 }
 
 /// Get remaining free memory
@@ -170,6 +678,44 @@ export fn wasm_free_space() callconv(.C) usize {
     return 0;
 }
 
+// ============================================================================
+// Bulk Helpers (SIMD128 in the wasm-simd build)
+// ============================================================================
+
+/// 1 if this module was built with simd128, else 0
+export fn wasm_simd_enabled() callconv(.C) i32 {
+    return @intFromBool(bulk.wasm_simd_enabled);
+}
+
+/// 1 if [ptr, ptr+len) is valid UTF-8, else 0
+export fn wasm_validate_utf8(ptr: [*]const u8, len: usize) callconv(.C) i32 {
+    return @intFromBool(bulk.validateUtf8(ptr[0..len]));
+}
+
+/// Copy len bytes between non-overlapping regions
+export fn wasm_copy(dst: [*]u8, src: [*]const u8, len: usize) callconv(.C) void {
+    bulk.copy(dst[0..len], src[0..len]);
+}
+
+/// Lexicographic comparison: -1, 0 or 1
+export fn wasm_compare(a: [*]const u8, a_len: usize, b: [*]const u8, b_len: usize) callconv(.C) i32 {
+    return switch (bulk.compare(a[0..a_len], b[0..b_len])) {
+        .lt => -1,
+        .eq => 0,
+        .gt => 1,
+    };
+}
+
+/// Sum of len bytes
+export fn wasm_sum_u8(ptr: [*]const u8, len: usize) callconv(.C) u64 {
+    return bulk.sumBytes(ptr[0..len]);
+}
+
+/// Sum of len f64 values
+export fn wasm_sum_f64(ptr: [*]const f64, len: usize) callconv(.C) f64 {
+    return bulk.sumF64(ptr[0..len]);
+}
+
 // ============================================================================
 // Type Marshalling for WASM
 // ============================================================================
@@ -213,34 +759,178 @@ pub fn unpackMaybe(comptime T: type, tag: i32, value: i64) ?T {
 // Callback Registry
 // ============================================================================
 
-/// Maximum number of registered callbacks
-const MAX_CALLBACKS = 256;
-
-/// Callback function type
+/// Callback taking a single integer argument
 pub const CallbackFn = *const fn (usize) void;
 
-/// Registered callbacks
-var callbacks: [MAX_CALLBACKS]?CallbackFn = [_]?CallbackFn{null} ** MAX_CALLBACKS;
-var next_callback_id: u32 = 0;
+/// Callback taking a borrowed view of bytes in linear memory
+pub const PayloadCallbackFn = *const fn (payload: []const u8) void;
+
+/// Slot table behind the callback ids handed to JavaScript.
+///
+/// An id is `generation << 16 | slot`. Unregistering a callback bumps its
+/// slot's generation and puts the slot on a free list, so ids are recycled
+/// without a stale id ever reaching the new occupant. One-shot callbacks
+/// (timers, animation frames) free their slot as they are invoked, so a
+/// page that schedules one per frame only ever holds a few slots.
+pub const callbacks = struct {
+    /// Maximum number of live callbacks
+    pub const capacity = 4096;
+
+    pub const Callback = union(enum) {
+        plain: CallbackFn,
+        payload: PayloadCallbackFn,
+    };
+
+    const no_slot = std.math.maxInt(u16);
+
+    const Slot = struct {
+        callback: ?Callback = null,
+        generation: u16 = 0,
+        once: bool = false,
+        next_free: u16 = no_slot,
+    };
+
+    var slots: [capacity]Slot = [_]Slot{.{}} ** capacity;
+    /// Slots below this index have been handed out at least once
+    var high_water: u16 = 0;
+    var free_head: u16 = no_slot;
+    var live: u32 = 0;
+
+    fn makeId(index: u16, generation: u16) u32 {
+        return @as(u32, generation) << 16 | index;
+    }
+
+    /// Register a callback; null when all slots are in use
+    pub fn register(callback: Callback, once: bool) ?u32 {
+        const index = if (free_head != no_slot) blk: {
+            const i = free_head;
+            free_head = slots[i].next_free;
+            break :blk i;
+        } else if (high_water < capacity) blk: {
+            high_water += 1;
+            break :blk high_water - 1;
+        } else return null;
+
+        const slot = &slots[index];
+        slot.callback = callback;
+        slot.once = once;
+        live += 1;
+        return makeId(index, slot.generation);
+    }
+
+    /// Slot index for a live id, or null if it was never issued or is stale
+    fn resolve(id: u32) ?u16 {
+        const index: u16 = @truncate(id);
+        if (index >= high_water) return null;
+        const slot = &slots[index];
+        if (slot.callback == null or slot.generation != @as(u16, @truncate(id >> 16))) return null;
+        return index;
+    }
+
+    fn release(index: u16) void {
+        const slot = &slots[index];
+        slot.callback = null;
+        slot.generation +%= 1;
+        slot.next_free = free_head;
+        free_head = index;
+        live -= 1;
+    }
+
+    /// Remove a callback. Returns false for unknown or stale ids.
+    pub fn unregister(id: u32) bool {
+        release(resolve(id) orelse return false);
+        return true;
+    }
+
+    /// Take the callback for `id`, releasing the slot first if it is
+    /// one-shot so the callback can immediately register a successor
+    fn take(id: u32) ?Callback {
+        const index = resolve(id) orelse return null;
+        const callback = slots[index].callback.?;
+        if (slots[index].once) release(index);
+        return callback;
+    }
+
+    /// Invoke with an integer argument. Payload callbacks get an empty view.
+    pub fn invoke(id: u32, arg: usize) void {
+        switch (take(id) orelse return) {
+            .plain => |f| f(arg),
+            .payload => |f| f(&.{}),
+        }
+    }
+
+    /// Invoke with a payload view. Plain callbacks get the payload address.
+    pub fn invokePayload(id: u32, payload: []const u8) void {
+        switch (take(id) orelse return) {
+            .plain => |f| f(@intFromPtr(payload.ptr)),
+            .payload => |f| f(payload),
+        }
+    }
+
+    /// Number of live callbacks
+    pub fn count() u32 {
+        return live;
+    }
+
+    /// Drop every callback; all outstanding ids become stale
+    pub fn clear() void {
+        for (slots[0..high_water], 0..) |slot, i| {
+            if (slot.callback != null) release(@intCast(i));
+        }
+    }
+};
 
 /// Register a callback and return its ID
 pub fn registerCallback(func: CallbackFn) ?u32 {
-    if (next_callback_id >= MAX_CALLBACKS) {
-        return null;
-    }
-    const id = next_callback_id;
-    callbacks[id] = func;
-    next_callback_id += 1;
+    return callbacks.register(.{ .plain = func }, false);
+}
+
+/// Register a callback that receives a pointer+len payload view
+pub fn registerPayloadCallback(func: PayloadCallbackFn) ?u32 {
+    return callbacks.register(.{ .payload = func }, false);
+}
+
+/// Remove a callback registered with registerCallback or
+/// registerPayloadCallback
+pub fn unregisterCallback(id: u32) bool {
+    return callbacks.unregister(id);
+}
+
+/// Run `func` after `delay_ms` through JavaScript's setTimeout. The id is
+/// released when the timer fires.
+pub fn setTimeout(func: CallbackFn, delay_ms: u32) ?u32 {
+    const id = callbacks.register(.{ .plain = func }, true) orelse return null;
+    js.js_set_timeout(id, delay_ms);
+    return id;
+}
+
+/// Run `func` on the next animation frame. The id is released when the
+/// frame callback runs; register again from `func` to keep a loop going.
+pub fn requestAnimationFrame(func: CallbackFn) ?u32 {
+    const id = callbacks.register(.{ .plain = func }, true) orelse return null;
+    js.js_request_animation_frame(id);
     return id;
 }
 
 /// Invoke a callback by ID
 export fn wasm_invoke_callback(id: u32, arg: usize) callconv(.C) void {
-    if (id < MAX_CALLBACKS) {
-        if (callbacks[id]) |func| {
-            func(arg);
-        }
-    }
+    callbacks.invoke(id, arg);
+}
+
+/// Invoke a callback by ID with a view of `len` bytes at `ptr`
+export fn wasm_invoke_callback_payload(id: u32, ptr: [*]const u8, len: usize) callconv(.C) void {
+    callbacks.invokePayload(id, ptr[0..len]);
+}
+
+/// Unregister a callback (e.g. a cancelled timer). 0 on success, -1 if
+/// the id is unknown or stale.
+export fn wasm_unregister_callback(id: u32) callconv(.C) i32 {
+    return if (callbacks.unregister(id)) 0 else -1;
+}
+
+/// Number of live callbacks
+export fn wasm_callback_count() callconv(.C) u32 {
+    return callbacks.count();
 }
 
 // ============================================================================
@@ -265,6 +955,92 @@ test "wasm allocator" {
     try std.testing.expect(alloc.freeSpace() == buffer.len);
 }
 
+test "wasm free-list allocator reuses and coalesces" {
+    if (builtin.target.cpu.arch == .wasm32) return;
+
+    var buffer: [4096]u8 align(16) = undefined;
+    var alloc = WasmAllocator.initMode(@intFromPtr(&buffer), buffer.len, .free_list);
+
+    const a = alloc.alloc(100, 8).?;
+    const b = alloc.alloc(100, 8).?;
+    const c = alloc.alloc(100, 8).?;
+
+    // A freed block is reused by a request of the same class
+    alloc.free(b);
+    try std.testing.expectEqual(b, alloc.alloc(90, 8).?);
+
+    // Freeing neighbours coalesces them into one block
+    alloc.free(a);
+    alloc.free(b);
+    const ab = alloc.alloc(220, 8).?;
+    try std.testing.expectEqual(a, ab);
+
+    // Everything freed returns to the untouched tail
+    alloc.free(ab);
+    alloc.free(c);
+    try std.testing.expectEqual(buffer.len, alloc.freeSpace());
+    try std.testing.expectEqual(alloc.heap_base, alloc.current);
+
+    try std.testing.expect(alloc.alloc(8, 64) == null);
+    try std.testing.expect(alloc.alloc(buffer.len, 8) == null);
+}
+
+test "shared ring batches records and wraps" {
+    if (builtin.target.cpu.arch == .wasm32) return;
+
+    var req_mem: [@sizeOf(RingHeader) + 64]u8 align(8) = undefined;
+    var resp_mem: [@sizeOf(RingHeader) + 256]u8 align(8) = undefined;
+    const request = SharedRing.init(&req_mem).?;
+    const response = SharedRing.init(&resp_mem).?;
+    try std.testing.expectEqual(@as(u32, 64), request.header.capacity);
+
+    const echo = struct {
+        fn handle(tag: u32, payload: []const u8, out: SharedRing) void {
+            _ = out.push(tag + 100, payload);
+        }
+    }.handle;
+
+    // Three 16-byte records, then a 24-byte one that must wrap
+    for (0..3) |i| try std.testing.expect(request.push(@intCast(i), "abcdefgh"));
+    try std.testing.expect(!request.push(9, "0123456789abcdef"));
+    try std.testing.expectEqual(@as(u32, 2), processRing(request, response, echo, 2));
+    try std.testing.expect(request.push(3, "0123456789abcdef"));
+    try std.testing.expectEqual(@as(u32, 2), processRing(request, response, echo, 10));
+    try std.testing.expectEqual(@as(u32, 0), request.pending());
+
+    var tags: [4]u32 = undefined;
+    for (&tags) |*tag| {
+        const record = response.peek().?;
+        tag.* = record.tag;
+        response.consume(record);
+    }
+    try std.testing.expectEqualSlices(u32, &.{ 100, 101, 102, 103 }, &tags);
+    try std.testing.expect(response.peek() == null);
+}
+
+test "wasm ring init releases rings it cannot use or replaces" {
+    if (builtin.target.cpu.arch == .wasm32) return;
+
+    var buffer: [8192]u8 align(16) = undefined;
+    try std.testing.expectEqual(@as(i32, 0), wasm_init_heap(@intFromPtr(&buffer), buffer.len, 1));
+    defer wasm_allocator = null;
+    const empty = wasm_free_space();
+
+    // Too small for a ring: nothing stays allocated
+    try std.testing.expectEqual(@as(usize, 0), wasm_ring_init(4, 256));
+    try std.testing.expectEqual(empty, wasm_free_space());
+    try std.testing.expectEqual(@as(usize, 0), wasm_ring_request());
+
+    // Re-initialising returns the previous rings to the heap
+    try std.testing.expect(wasm_ring_init(256, 256) != 0);
+    const in_use = wasm_free_space();
+    for (0..10) |_| try std.testing.expect(wasm_ring_init(256, 256) != 0);
+    try std.testing.expectEqual(in_use, wasm_free_space());
+
+    wasm_reset();
+    try std.testing.expectEqual(@as(usize, 0), wasm_ring_response());
+}
+
 test "maybe packing" {
     if (builtin.target.cpu.arch == .wasm32) return;
 
@@ -281,3 +1057,43 @@ test "maybe packing" {
     try std.testing.expect(unpackMaybe(i64, packed_some[0], packed_some[1]) == 42);
     try std.testing.expect(unpackMaybe(i64, packed_none[0], packed_none[1]) == null);
 }
+
+test "wasm callback ids are recycled with generations" {
+    if (builtin.target.cpu.arch == .wasm32) return;
+
+    const Probe = struct {
+        var calls: usize = 0;
+        var last_len: usize = 0;
+
+        fn onCall(_: usize) void {
+            calls += 1;
+        }
+
+        fn onPayload(payload: []const u8) void {
+            last_len = payload.len;
+        }
+    };
+    callbacks.clear();
+    defer callbacks.clear();
+
+    // One-shot registrations far beyond capacity keep reusing one slot
+    for (0..callbacks.capacity * 2) |_| {
+        const id = callbacks.register(.{ .plain = Probe.onCall }, true).?;
+        callbacks.invoke(id, 0);
+        callbacks.invoke(id, 0); // stale: ignored
+    }
+    try std.testing.expectEqual(@as(usize, callbacks.capacity * 2), Probe.calls);
+    try std.testing.expectEqual(@as(u32, 0), callbacks.count());
+
+    const a = registerCallback(Probe.onCall).?;
+    try std.testing.expect(unregisterCallback(a));
+    const b = registerPayloadCallback(Probe.onPayload).?;
+    try std.testing.expect((a & 0xFFFF) == (b & 0xFFFF));
+    try std.testing.expect(a != b);
+    try std.testing.expect(!unregisterCallback(a));
+
+    const payload = "hello";
+    callbacks.invokePayload(b, payload);
+    try std.testing.expectEqual(@as(usize, 5), Probe.last_len);
+    try std.testing.expectEqual(@as(u32, 1), callbacks.count());
+}
@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: Palimpsest-MPL-1.0
+//! Bulk byte and array helpers with 128-bit vector paths
+//!
+//! validateUtf8, copy, compare and the sums work on 16-byte @Vector chunks.
+//! These lower to WebAssembly SIMD128 (v128) when the wasm target enables
+//! it (`zig build wasm-simd`), to SSE/NEON natively, and to plain loops on
+//! a wasm32 build without SIMD. Each helper has a *Scalar twin that serves
+//! as the reference implementation for tests and the wasmtime harness.
+
+const std = @import("std");
+const builtin = @import("builtin");
+const kernels = @import("kernels.zig");
+
+/// Bytes per vector step (one v128)
+pub const vector_len = 16;
+const V = @Vector(vector_len, u8);
+
+/// True when compiled for wasm32 with the simd128 feature
+pub const wasm_simd_enabled = builtin.cpu.arch == .wasm32 and
+    std.Target.wasm.featureSetHas(builtin.cpu.features, .simd128);
+
+inline fn chunk(bytes: []const u8, i: usize) V {
+    return bytes[i..][0..vector_len].*;
+}
+
+// ============================================================================
+// UTF-8 Validation
+// ============================================================================
+
+/// Validate UTF-8. Leading ASCII is skipped 16 bytes at a time; the rest
+/// goes through the standard validator.
+pub fn validateUtf8(bytes: []const u8) bool {
+    const high: V = @splat(0x80);
+    var i: usize = 0;
+    while (i + vector_len <= bytes.len) : (i += vector_len) {
+        if (@reduce(.Or, chunk(bytes, i) & high) != 0) break;
+    }
+    // Everything before i is ASCII, so i is on a code point boundary
+    return std.unicode.utf8ValidateSlice(bytes[i..]);
+}
+
+/// Byte-at-a-time reference for validateUtf8
+pub fn validateUtf8Scalar(bytes: []const u8) bool {
+    var i: usize = 0;
+    while (i < bytes.len and bytes[i] < 0x80) : (i += 1) {}
+    return std.unicode.utf8ValidateSlice(bytes[i..]);
+}
+
+// ============================================================================
+// Copy and Compare
+// ============================================================================
+
+/// Copy src into dst (equal lengths, no overlap)
+pub fn copy(dst: []u8, src: []const u8) void {
+    std.debug.assert(dst.len == src.len);
+    var i: usize = 0;
+    while (i + vector_len <= src.len) : (i += vector_len) {
+        dst[i..][0..vector_len].* = chunk(src, i);
+    }
+    while (i < src.len) : (i += 1) dst[i] = src[i];
+}
+
+/// Byte-at-a-time reference for copy
+pub fn copyScalar(dst: []u8, src: []const u8) void {
+    std.debug.assert(dst.len == src.len);
+    for (dst, src) |*d, s| d.* = s;
+}
+
+/// Lexicographic byte comparison
+pub fn compare(a: []const u8, b: []const u8) std.math.Order {
+    const n = @min(a.len, b.len);
+    var i: usize = 0;
+    // Skip equal 16-byte chunks; the first differing one is resolved below
+    while (i + vector_len <= n) : (i += vector_len) {
+        if (@reduce(.Or, chunk(a, i) != chunk(b, i))) break;
+    }
+    while (i < n) : (i += 1) {
+        if (a[i] != b[i]) return std.math.order(a[i], b[i]);
+    }
+    return std.math.order(a.len, b.len);
+}
+
+/// Byte-at-a-time reference for compare
+pub fn compareScalar(a: []const u8, b: []const u8) std.math.Order {
+    for (a[0..@min(a.len, b.len)], 0..) |x, i| {
+        if (x != b[i]) return std.math.order(x, b[i]);
+    }
+    return std.math.order(a.len, b.len);
+}
+
+// ============================================================================
+// Sums
+// ============================================================================
+
+/// Sum of all bytes. Lanes accumulate in u32 and are folded into the u64
+/// total before they can overflow.
+pub fn sumBytes(bytes: []const u8) u64 {
+    const W = @Vector(vector_len, u32);
+    // 255 * flush_chunks stays below 2^32
+    const flush_chunks = 1 << 16;
+
+    var total: u64 = 0;
+    var i: usize = 0;
+    while (i + vector_len <= bytes.len) {
+        var acc: W = @splat(0);
+        var k: usize = 0;
+        while (k < flush_chunks and i + vector_len <= bytes.len) : ({
+            k += 1;
+            i += vector_len;
+        }) {
+            acc += @as(W, @intCast(chunk(bytes, i)));
+        }
+        total += @reduce(.Add, acc);
+    }
+    while (i < bytes.len) : (i += 1) total += bytes[i];
+    return total;
+}
+
+/// Byte-at-a-time reference for sumBytes
+pub fn sumBytesScalar(bytes: []const u8) u64 {
+    var total: u64 = 0;
+    for (bytes) |b| total += b;
+    return total;
+}
+
+/// Sum of f64 values (vector lanes; may differ from the scalar sum in the
+/// last bits because of summation order)
+pub fn sumF64(xs: []const f64) f64 {
+    return kernels.sum(f64, xs);
+}
+
+/// Sequential reference for sumF64
+pub fn sumF64Scalar(xs: []const f64) f64 {
+    var total: f64 = 0;
+    for (xs) |x| total += x;
+    return total;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "vector helpers match scalar references" {
+    var text: [100]u8 = undefined;
+    for (&text, 0..) |*c, i| c.* = @intCast('a' + i % 26);
+
+    try std.testing.expect(validateUtf8(&text));
+    try std.testing.expect(validateUtf8("plain ascii prefix, then \xc3\xa9"));
+    try std.testing.expect(!validateUtf8("plain ascii prefix, then \xc3"));
+    try std.testing.expectEqual(validateUtf8Scalar(&text), validateUtf8(&text));
+
+    var out: [100]u8 = undefined;
+    copy(&out, &text);
+    try std.testing.expectEqualSlices(u8, &text, &out);
+
+    try std.testing.expectEqual(std.math.Order.eq, compare(&text, &out));
+    out[70] = 'Z';
+    try std.testing.expectEqual(compareScalar(&text, &out), compare(&text, &out));
+    try std.testing.expectEqual(std.math.Order.lt, compare(text[0..50], &text));
+
+    try std.testing.expectEqual(sumBytesScalar(&text), sumBytes(&text));
+}
@@ -3,6 +3,10 @@
 //!
 //! This module provides error types and utilities for working with
 //! Idris functions that return Either Error Value.
+//!
+//! Hot validation paths can use CompactError instead of IdrisError: eight
+//! bytes (code, static message id, context stamp) that never allocate.
+//! Message text is only looked up when somebody asks for it.
 
 const std = @import("std");
 const idris_rts = @import("idris_rts.zig");
@@ -96,20 +100,179 @@ pub fn Result(comptime T: type) type {
     };
 }
 
+// ============================================================================
+// Compact Errors
+// ============================================================================
+
+/// Index into the static message table. `none` means "describe the code".
+pub const MessageId = enum(u16) { none = 0, _ };
+
+/// Maximum number of registered messages (including `none`)
+pub const max_messages = 256;
+
+/// Bytes of detail kept per thread for the most recent error
+pub const context_capacity = 256;
+
+const messages = struct {
+    var table: [max_messages][]const u8 = [_][]const u8{""} ** max_messages;
+    var count = std.atomic.Value(u16).init(1);
+    var lock: std.Thread.Mutex = .{};
+};
+
+/// Register a message that lives for the rest of the program (a string
+/// literal or other static memory) and return its id. Meant for start-up;
+/// lookups afterwards take no lock.
+pub fn registerMessage(text: []const u8) !MessageId {
+    messages.lock.lock();
+    defer messages.lock.unlock();
+    const id = messages.count.load(.monotonic);
+    if (id == max_messages) return error.TooManyMessages;
+    messages.table[id] = text;
+    messages.count.store(id + 1, .release);
+    return @enumFromInt(id);
+}
+
+/// Text for a message id, or null for `none` and unknown ids
+pub fn messageText(id: MessageId) ?[]const u8 {
+    const index = @intFromEnum(id);
+    if (index == 0 or index >= messages.count.load(.acquire)) return null;
+    return messages.table[index];
+}
+
+/// Per-thread detail for the latest error raised with context. The stamp
+/// lets a CompactError tell whether the buffer still holds its own detail.
+const ErrorContext = struct {
+    buf: [context_capacity]u8 = undefined,
+    len: usize = 0,
+    stamp: u16 = 0,
+};
+
+threadlocal var error_context: ErrorContext = .{};
+
+/// Error as a code, a static message id and a context stamp. Building one
+/// only writes these eight bytes (plus the thread-local context buffer
+/// when detail is attached); message text is resolved on demand.
+pub const CompactError = extern struct {
+    code: u32,
+    message_id: MessageId = .none,
+    /// Stamp of this thread's context buffer, 0 when there is no detail
+    context_stamp: u16 = 0,
+
+    pub fn init(code: ErrorCode, message_id: MessageId) CompactError {
+        return .{ .code = @intFromEnum(code), .message_id = message_id };
+    }
+
+    /// Error with formatted detail written into the calling thread's
+    /// context buffer (truncated to context_capacity). The detail stays
+    /// readable until this thread records the next error with context.
+    pub fn withContext(code: ErrorCode, message_id: MessageId, comptime fmt: []const u8, args: anytype) CompactError {
+        const ctx = &error_context;
+        var stream = std.io.fixedBufferStream(&ctx.buf);
+        stream.writer().print(fmt, args) catch {}; // keep what fitted
+        ctx.len = stream.pos;
+        ctx.stamp +%= 1;
+        if (ctx.stamp == 0) ctx.stamp = 1;
+        return .{ .code = @intFromEnum(code), .message_id = message_id, .context_stamp = ctx.stamp };
+    }
+
+    /// The code as an ErrorCode (`unknown` for codes outside the enum)
+    pub fn errorCode(self: CompactError) ErrorCode {
+        return std.meta.intToEnum(ErrorCode, self.code) catch .unknown;
+    }
+
+    /// Static message text: the registered message, else the code's name
+    pub fn message(self: CompactError) []const u8 {
+        if (messageText(self.message_id)) |text| return text;
+        return @tagName(self.errorCode());
+    }
+
+    /// Detail from the context buffer. Only valid on the thread that
+    /// created the error; null once newer detail has replaced it.
+    pub fn context(self: CompactError) ?[]const u8 {
+        const ctx = &error_context;
+        if (self.context_stamp == 0 or self.context_stamp != ctx.stamp) return null;
+        return ctx.buf[0..ctx.len];
+    }
+
+    /// Full error view. The context slice borrows the thread-local buffer.
+    pub fn toIdrisError(self: CompactError) IdrisError {
+        return .{
+            .code = self.errorCode(),
+            .message = self.message(),
+            .context = self.context(),
+        };
+    }
+
+    /// Write "Error <code>: <message> (context: ...)"
+    pub fn writeTo(self: CompactError, writer: anytype) !void {
+        try writer.print("Error {d}: {s}", .{ self.code, self.message() });
+        if (self.context()) |ctx| {
+            try writer.print(" (context: {s})", .{ctx});
+        }
+    }
+};
+
+/// Result whose error side is a CompactError
+pub fn CompactResult(comptime T: type) type {
+    return union(enum) {
+        ok: T,
+        err: CompactError,
+
+        const Self = @This();
+
+        pub fn fail(code: ErrorCode, message_id: MessageId) Self {
+            return .{ .err = CompactError.init(code, message_id) };
+        }
+
+        pub fn isOk(self: Self) bool {
+            return self == .ok;
+        }
+
+        pub fn isErr(self: Self) bool {
+            return self == .err;
+        }
+
+        pub fn unwrapOr(self: Self, default: T) T {
+            return switch (self) {
+                .ok => |v| v,
+                .err => default,
+            };
+        }
+
+        /// Materialise the full Result (message and context resolved now)
+        pub fn toResult(self: Self) Result(T) {
+            return switch (self) {
+                .ok => |v| .{ .ok = v },
+                .err => |e| .{ .err = e.toIdrisError() },
+            };
+        }
+    };
+}
+
 // ============================================================================
 // Error Conversion
 // ============================================================================
 
-/// Convert an Idris Either to a Result
+/// Convert an Idris Either to a Result. The error message borrows from
+/// the Idris left value, so it is valid while that value is alive.
+/// A missing payload reads as "Unknown error" or `.int = 0`, as in
+/// native.idrisEitherToCResult.
 pub fn fromIdrisEither(either: idris_rts.IdrisEitherValue) Result(idris_rts.IdrisValue) {
     return switch (either.tag) {
-        .left => .{ .err = parseError(either.left) },
-        .right => .{ .ok = either.right },
+        .left => .{ .err = if (eitherPayload(either.left_ptr)) |left|
+            parseError(left)
+        else
+            makeError(.unknown, "Unknown error") },
+        .right => .{ .ok = if (eitherPayload(either.right_ptr)) |right| right.* else .{ .int = 0 } },
     };
 }
 
+fn eitherPayload(ptr: ?*anyopaque) ?*const idris_rts.IdrisValue {
+    return @ptrCast(@alignCast(ptr orelse return null));
+}
+
 /// Parse an Idris error value into our error type
-fn parseError(value: idris_rts.IdrisValue) IdrisError {
+fn parseError(value: *const idris_rts.IdrisValue) IdrisError {
     // Try to extract error information from the Idris value
     // This depends on how errors are structured in the Idris code
 
@@ -121,11 +284,11 @@ fn parseError(value: idris_rts.IdrisValue) IdrisError {
     };
 }
 
-/// Extract error message from Idris value
-fn extractErrorMessage(value: idris_rts.IdrisValue) []const u8 {
+/// Extract error message from Idris value (borrowed, never copied)
+fn extractErrorMessage(value: *const idris_rts.IdrisValue) []const u8 {
     // If it's a string, use it directly
-    if (value.string.data != null) {
-        return types.fromIdrisString(value.string);
+    if (value.string.length() > 0) {
+        return types.fromIdrisString(&value.string);
     }
 
     // Otherwise return generic message
@@ -208,6 +371,23 @@ test "Result err" {
     try std.testing.expect(result.unwrapOr(0) == 0);
 }
 
+test "Idris error messages borrow from the left value" {
+    var left = idris_rts.IdrisValue{ .string = idris_rts.IdrisString.initInline("bad input") };
+    const either = idris_rts.IdrisEitherValue{ .tag = .left, .left_ptr = &left, .right_ptr = null };
+    const result = fromIdrisEither(either);
+    try std.testing.expectEqualStrings("bad input", result.err.message);
+    try std.testing.expectEqual(@as([*]const u8, @ptrCast(&left)), result.err.message.ptr);
+}
+
+test "Idris Either without a payload" {
+    const left = fromIdrisEither(.{ .tag = .left, .left_ptr = null, .right_ptr = null });
+    try std.testing.expectEqual(ErrorCode.unknown, left.err.code);
+    try std.testing.expectEqualStrings("Unknown error", left.err.message);
+
+    const right = fromIdrisEither(.{ .tag = .right, .left_ptr = null, .right_ptr = null });
+    try std.testing.expectEqual(@as(i64, 0), right.ok.int);
+}
+
 test "error formatting" {
     const err = makeErrorWithContext(.injection_detected, "SQL injection detected", "user_input");
     var buf: [256]u8 = undefined;
@@ -217,3 +397,25 @@ test "error formatting" {
     const output = stream.getWritten();
     try std.testing.expect(std.mem.indexOf(u8, output, "SQL injection") != null);
 }
+
+test "compact errors resolve messages lazily" {
+    try std.testing.expectEqual(@as(usize, 8), @sizeOf(CompactError));
+
+    const plain = CompactError.init(.out_of_range, .none);
+    try std.testing.expectEqualStrings("out_of_range", plain.message());
+    try std.testing.expect(plain.context() == null);
+
+    const id = try registerMessage("value must be positive");
+    const first = CompactError.withContext(.validation_error, id, "field {s} = {d}", .{ "age", -3 });
+    try std.testing.expectEqualStrings("value must be positive", first.message());
+    try std.testing.expectEqualStrings("field age = -3", first.context().?);
+
+    // Newer detail on this thread supersedes the old context
+    const second = CompactError.withContext(.overflow, .none, "{d}", .{1 << 40});
+    try std.testing.expect(first.context() == null);
+    try std.testing.expectEqualStrings("1099511627776", second.context().?);
+
+    const result = CompactResult(i32).fail(.division_by_zero, .none);
+    try std.testing.expectEqual(@as(i32, 7), result.unwrapOr(7));
+    try std.testing.expectEqual(ErrorCode.division_by_zero, result.toResult().err.code);
+}
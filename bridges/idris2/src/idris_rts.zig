@@ -6,6 +6,8 @@
 //! Zig and Idris 2 verified code.
 
 const std = @import("std");
+const builtin = @import("builtin");
+const build_options = @import("build_options");
 
 // ============================================================================
 // Core Idris Types
@@ -21,9 +23,84 @@ pub const IdrisValue = extern union {
 };
 
 /// Idris String representation
+///
+/// Three forms share the same two-word layout:
+/// - heap: `data` is owned by memory.allocator (freeIdrisString frees it)
+/// - borrowed: `data` belongs to someone else (a scope, an arena, static
+///   memory); freeIdrisString leaves it alone
+/// - inline: up to `inline_capacity` bytes stored in the struct itself, no
+///   allocation at all; the last byte holds the length
+///
+/// The flags live in the top bits of `len`, so read strings through
+/// slice()/length() rather than the raw fields. Inline bytes live in the
+/// struct, so a slice is only valid while that struct is.
 pub const IdrisString = extern struct {
     data: ?[*]u8,
     len: usize,
+
+    const inline_flag: usize = 1 << (@bitSizeOf(usize) - 1);
+    const borrowed_flag: usize = 1 << (@bitSizeOf(usize) - 2);
+    const len_mask: usize = borrowed_flag - 1;
+
+    /// Longest string stored inline: 15 bytes on 64-bit targets, 7 on wasm32.
+    /// The length byte must be the high byte of `len`, so big-endian targets
+    /// never store strings inline.
+    pub const inline_capacity: usize = if (builtin.cpu.arch.endian() == .little)
+        @sizeOf(usize) * 2 - 1
+    else
+        0;
+
+    pub fn empty() IdrisString {
+        return .{ .data = null, .len = 0 };
+    }
+
+    /// Borrow bytes owned elsewhere (no copy, never freed by the bridge)
+    pub fn borrowed(bytes: []const u8) IdrisString {
+        if (bytes.len == 0) return empty();
+        return .{ .data = @constCast(bytes.ptr), .len = bytes.len | borrowed_flag };
+    }
+
+    /// Store up to inline_capacity bytes inside the struct
+    pub fn initInline(bytes: []const u8) IdrisString {
+        std.debug.assert(bytes.len <= inline_capacity);
+        var str: IdrisString = undefined;
+        const raw = std.mem.asBytes(&str);
+        @memset(raw, 0);
+        @memcpy(raw[0..bytes.len], bytes);
+        raw[raw.len - 1] = @as(u8, @intCast(bytes.len)) | 0x80;
+        return str;
+    }
+
+    pub fn isInline(self: IdrisString) bool {
+        return self.len & inline_flag != 0;
+    }
+
+    pub fn isBorrowed(self: IdrisString) bool {
+        return !self.isInline() and self.len & borrowed_flag != 0;
+    }
+
+    /// True if freeIdrisString must release `data`
+    pub fn isOwned(self: IdrisString) bool {
+        return !self.isInline() and !self.isBorrowed() and self.data != null;
+    }
+
+    pub fn length(self: IdrisString) usize {
+        if (self.isInline()) return std.mem.asBytes(&self)[@sizeOf(IdrisString) - 1] & 0x7f;
+        return self.len & len_mask;
+    }
+
+    /// The string bytes; points into `self` for inline strings
+    pub fn slice(self: *const IdrisString) []const u8 {
+        if (self.isInline()) return std.mem.asBytes(self)[0..self.length()];
+        if (self.data) |data| return data[0..self.length()];
+        return "";
+    }
+
+    /// Heap bytes to release, or null for inline/borrowed/empty strings
+    pub fn ownedBytes(self: IdrisString) ?[]u8 {
+        if (!self.isOwned()) return null;
+        return self.data.?[0..self.len];
+    }
 };
 
 /// Generic Maybe value (untyped) - uses pointer to avoid circular dependency
@@ -85,6 +162,17 @@ pub fn IdrisList(comptime T: type) type {
     };
 }
 
+/// Contiguous array: one pointer + length, elements stored inline.
+/// Used for bulk numeric data instead of linked IdrisList nodes.
+pub fn IdrisArray(comptime T: type) type {
+    return extern struct {
+        data: ?[*]T,
+        len: usize,
+        /// Non-zero if the bridge allocated `data` and must free it
+        owned: u8,
+    };
+}
+
 /// Idris Pair/Tuple
 pub fn IdrisPair(comptime A: type, comptime B: type) type {
     return struct {
@@ -104,58 +192,365 @@ pub const IdrisConstructor = extern struct {
 // Runtime Initialization
 // ============================================================================
 
-/// Whether the runtime has been initialized
-var runtime_initialized: bool = false;
+/// Set once initialization has completed. Readers only need an acquire
+/// load, so the check on every call stays lock-free.
+var runtime_ready = std.atomic.Value(bool).init(false);
+
+/// Serialises init and deinit so idris2_init runs exactly once even when
+/// several threads race to initialise
+var runtime_lock: std.Thread.Mutex = .{};
 
 /// Initialize the Idris 2 runtime
-/// This must be called before any Idris functions are invoked
+/// This must be called before any Idris functions are invoked.
+/// Safe to call from several threads: one runs the initialisation and the
+/// others wait for it to finish.
 pub fn initRuntime() !void {
-    if (runtime_initialized) return;
+    if (runtime_ready.load(.acquire)) return;
+
+    runtime_lock.lock();
+    defer runtime_lock.unlock();
+    if (runtime_ready.load(.monotonic)) return;
 
     // Call Idris runtime initialization if available
     if (@hasDecl(@import("root"), "idris2_init")) {
         @import("root").idris2_init();
     }
 
-    runtime_initialized = true;
+    runtime_ready.store(true, .release);
 }
 
 /// Deinitialize the Idris 2 runtime
 pub fn deinitRuntime() void {
-    if (!runtime_initialized) return;
+    runtime_lock.lock();
+    defer runtime_lock.unlock();
+    if (!runtime_ready.load(.monotonic)) return;
+
+    // Roots must let go before the Idris runtime is torn down
+    gcReleaseAll();
 
     // Call Idris runtime cleanup if available
     if (@hasDecl(@import("root"), "idris2_deinit")) {
         @import("root").idris2_deinit();
     }
 
-    runtime_initialized = false;
+    runtime_ready.store(false, .release);
 }
 
 /// Check if runtime is initialized
 pub fn isInitialized() bool {
-    return runtime_initialized;
+    return runtime_ready.load(.acquire);
+}
+
+// ============================================================================
+// Per-Thread Runtime State
+// ============================================================================
+
+const Scratch = @import("memory.zig").Scratch;
+
+/// State owned by one OS thread calling into Idris code. Everything the
+/// call path needs per call lives here, so concurrent callers share
+/// nothing but the (lock-free on lookup) callback registry.
+pub const ThreadHandle = struct {
+    /// Scratch arena for marshalled arguments; see root.call
+    scratch: Scratch = .{},
+    /// Nesting depth of calls into Idris on this thread
+    call_depth: u32 = 0,
+    /// Open root.Scope count; while non-zero the scratch is not reset
+    scope_depth: u32 = 0,
+    attached: bool = false,
+};
+
+threadlocal var thread_handle: ThreadHandle = .{};
+var attached_threads = std.atomic.Value(u32).init(0);
+
+/// This thread's handle, attaching it on first use
+pub fn currentThread() *ThreadHandle {
+    const handle = &thread_handle;
+    if (!handle.attached) {
+        handle.attached = true;
+        _ = attached_threads.fetchAdd(1, .monotonic);
+    }
+    return handle;
+}
+
+/// Initialise the runtime if needed and attach the calling thread
+pub fn attachThread() !*ThreadHandle {
+    try initRuntime();
+    return currentThread();
+}
+
+/// Release the calling thread's scratch memory and allocator caches.
+/// Call before a thread that used the bridge exits.
+pub fn detachThread() void {
+    const handle = &thread_handle;
+    if (!handle.attached) return;
+    handle.scratch.deinit();
+    @import("memory.zig").flushThreadCache();
+    handle.* = .{};
+    _ = attached_threads.fetchSub(1, .monotonic);
+}
+
+/// Number of threads currently attached
+pub fn attachedThreadCount() u32 {
+    return attached_threads.load(.monotonic);
 }
 
 // ============================================================================
 // GC Integration
 // ============================================================================
 
-/// Hint to the Idris GC that we're holding a reference
-pub fn gcRoot(value: *IdrisValue) void {
-    // In production, this would register with Idris GC
-    _ = value;
+//
+// Zig keeps Idris values alive across calls through a root table. A root is
+// a handle (slot index + generation), so stale handles are detected instead
+// of reading a reused slot.
+//
+// Boxed values (RefC `Value *`) rooted with gcRootObject hold a RefC
+// reference: newReference when rooted, removeReference when released, so
+// Zig can keep zero-copy references to Idris buffers. The two entry points
+// come from, in order of precedence: gcSetRefcHooks (idris2_gc_set_refc_hooks
+// for C hosts), the RefC runtime linked in with -Drefc-runtime, or the root
+// module if it declares them (the same pattern as idris2_init). Without any
+// of these gcRootObject fails rather than root an object it cannot retain.
+//
+// RefC reference counts are not atomic. gcUnroot may be called from any
+// thread: it invalidates the handle at once but queues the removeReference,
+// which gcCollect performs on the thread that runs Idris code.
+
+/// Handle to a rooted value; `invalid` is never returned by gcRoot*
+pub const GcHandle = enum(u64) {
+    invalid = 0,
+    _,
+
+    fn init(slot_index: u32, gen: u32) GcHandle {
+        return @enumFromInt(@as(u64, gen) << 32 | slot_index);
+    }
+
+    fn index(self: GcHandle) u32 {
+        return @truncate(@intFromEnum(self));
+    }
+
+    fn generation(self: GcHandle) u32 {
+        return @intCast(@intFromEnum(self) >> 32);
+    }
+};
+
+const no_free_slot = std.math.maxInt(u32);
+
+const RootSlot = struct {
+    value: IdrisValue,
+    /// Starts at 1 and is bumped on release, so handle 0 never matches
+    generation: u32,
+    /// value.ptr holds a RefC reference to drop on release
+    object: bool,
+    live: bool,
+    next_free: u32,
+};
+
+const gc = struct {
+    var lock: std.Thread.Mutex = .{};
+    var slots: std.ArrayListUnmanaged(RootSlot) = .{};
+    var free_head: u32 = no_free_slot;
+    var live: usize = 0;
+    /// RefC objects whose release is waiting for gcCollect
+    var pending: std.ArrayListUnmanaged(*anyopaque) = .{};
+
+    fn allocator() std.mem.Allocator {
+        return @import("memory.zig").allocator;
+    }
+
+    fn insert(value: IdrisValue, object: bool) !GcHandle {
+        lock.lock();
+        defer lock.unlock();
+
+        // Reserve queue space now so release can never fail to record it
+        if (object) try pending.ensureUnusedCapacity(allocator(), live + 1);
+
+        const index: u32 = if (free_head != no_free_slot) blk: {
+            const i = free_head;
+            free_head = slots.items[i].next_free;
+            break :blk i;
+        } else blk: {
+            try slots.append(allocator(), .{
+                .value = undefined,
+                .generation = 1,
+                .object = false,
+                .live = false,
+                .next_free = no_free_slot,
+            });
+            break :blk @intCast(slots.items.len - 1);
+        };
+
+        const slot = &slots.items[index];
+        slot.value = value;
+        slot.object = object;
+        slot.live = true;
+        live += 1;
+        return GcHandle.init(index, slot.generation);
+    }
+
+    fn find(handle: GcHandle) ?*RootSlot {
+        const i = handle.index();
+        if (i >= slots.items.len) return null;
+        const slot = &slots.items[i];
+        if (!slot.live or slot.generation != handle.generation()) return null;
+        return slot;
+    }
+
+    /// Free a slot (lock held)
+    fn release(slot: *RootSlot, index: u32) void {
+        if (slot.object) {
+            if (slot.value.ptr) |ptr| pending.appendAssumeCapacity(ptr);
+        }
+        slot.live = false;
+        slot.object = false;
+        slot.generation +%= 1;
+        if (slot.generation == 0) slot.generation = 1;
+        slot.next_free = free_head;
+        free_head = index;
+        live -= 1;
+    }
+};
+
+/// RefC reference-count entry points used for gcRootObject roots
+pub const RefcHooks = extern struct {
+    retain: *const fn (obj: *anyopaque) callconv(.C) void,
+    release: *const fn (obj: *anyopaque) callconv(.C) void,
+};
+
+const refc = struct {
+    const linked = struct {
+        extern fn newReference(obj: *anyopaque) ?*anyopaque;
+        extern fn removeReference(obj: *anyopaque) void;
+
+        fn retain(obj: *anyopaque) callconv(.C) void {
+            _ = newReference(obj);
+        }
+
+        fn release(obj: *anyopaque) callconv(.C) void {
+            removeReference(obj);
+        }
+    };
+
+    const from_root = struct {
+        const root = @import("root");
+
+        fn retain(obj: *anyopaque) callconv(.C) void {
+            _ = root.newReference(@ptrCast(obj));
+        }
+
+        fn release(obj: *anyopaque) callconv(.C) void {
+            root.removeReference(@ptrCast(obj));
+        }
+    };
+
+    const default: ?RefcHooks = if (build_options.refc_runtime)
+        .{ .retain = linked.retain, .release = linked.release }
+    else if (@hasDecl(@import("root"), "newReference") and @hasDecl(@import("root"), "removeReference"))
+        .{ .retain = from_root.retain, .release = from_root.release }
+    else
+        null;
+
+    /// Guarded by gc.lock
+    var hooks: ?RefcHooks = default;
+};
+
+/// Install the RefC reference-count functions (null restores the build
+/// default). Set them before rooting objects: roots taken with one pair
+/// are released with whatever pair is installed at gcCollect time.
+pub fn gcSetRefcHooks(hooks: ?RefcHooks) void {
+    gc.lock.lock();
+    defer gc.lock.unlock();
+    refc.hooks = hooks orelse refc.default;
+}
+
+/// Root an unboxed value (Int, Double, a Zig-owned pointer...).
+/// The table keeps a copy; read it back with gcGet.
+pub fn gcRoot(value: IdrisValue) !GcHandle {
+    return gc.insert(value, false);
+}
+
+/// Root a boxed RefC object and take a reference to it, so it stays alive
+/// (and unmoved) until gcUnroot + gcCollect. Call on the Idris thread.
+/// Fails with error.RefcUnavailable if no RefC hooks are installed.
+pub fn gcRootObject(obj: *anyopaque) !GcHandle {
+    gc.lock.lock();
+    const hooks = refc.hooks;
+    gc.lock.unlock();
+
+    const retain = (hooks orelse return error.RefcUnavailable).retain;
+    const handle = try gc.insert(.{ .ptr = obj }, true);
+    retain(obj);
+    return handle;
+}
+
+/// Value held by a root, or null if the handle is stale
+pub fn gcGet(handle: GcHandle) ?IdrisValue {
+    gc.lock.lock();
+    defer gc.lock.unlock();
+    const slot = gc.find(handle) orelse return null;
+    return slot.value;
 }
 
-/// Release a GC root
-pub fn gcUnroot(value: *IdrisValue) void {
-    // In production, this would unregister from Idris GC
-    _ = value;
+/// Object held by a gcRootObject root, or null if the handle is stale
+pub fn gcGetObject(handle: GcHandle) ?*anyopaque {
+    gc.lock.lock();
+    defer gc.lock.unlock();
+    const slot = gc.find(handle) orelse return null;
+    return if (slot.object) slot.value.ptr else null;
 }
 
-/// Force a garbage collection cycle
-pub fn gcCollect() void {
-    // In production, this would trigger Idris GC
+/// Release a root. The handle is invalid immediately; a RefC reference is
+/// dropped by the next gcCollect. Stale handles are ignored.
+pub fn gcUnroot(handle: GcHandle) void {
+    gc.lock.lock();
+    defer gc.lock.unlock();
+    const slot = gc.find(handle) orelse return;
+    gc.release(slot, handle.index());
+}
+
+/// Drop RefC references queued by gcUnroot. Call on the Idris thread.
+/// Returns the number of references released.
+pub fn gcCollect() usize {
+    var released: usize = 0;
+    while (true) {
+        // Pop under the lock, release outside it: removeReference may free
+        // Idris data and re-enter the bridge. The queue keeps its capacity.
+        gc.lock.lock();
+        const obj = gc.pending.popOrNull();
+        const hooks = refc.hooks;
+        gc.lock.unlock();
+
+        const o = obj orelse break;
+        if (hooks) |h| h.release(o);
+        released += 1;
+    }
+    return released;
+}
+
+/// Number of live roots
+pub fn gcRootCount() usize {
+    gc.lock.lock();
+    defer gc.lock.unlock();
+    return gc.live;
+}
+
+/// Release every root and the table itself (used by deinitRuntime)
+fn gcReleaseAll() void {
+    gc.lock.lock();
+    for (gc.slots.items, 0..) |*slot, i| {
+        if (slot.live) gc.release(slot, @intCast(i));
+    }
+    gc.lock.unlock();
+
+    _ = gcCollect();
+
+    gc.lock.lock();
+    defer gc.lock.unlock();
+    gc.slots.deinit(gc.allocator());
+    gc.slots = .{};
+    gc.pending.deinit(gc.allocator());
+    gc.pending = .{};
+    gc.free_head = no_free_slot;
 }
 
 // ============================================================================
@@ -219,6 +614,26 @@ test "IdrisString layout" {
     const str = IdrisString{ .data = null, .len = 0 };
     try std.testing.expect(str.len == 0);
     try std.testing.expect(str.data == null);
+    try std.testing.expectEqual(@as(usize, 2 * @sizeOf(usize)), @sizeOf(IdrisString));
+}
+
+test "IdrisString inline and borrowed forms" {
+    if (IdrisString.inline_capacity == 0) return;
+
+    const short = IdrisString.initInline("user_id");
+    try std.testing.expect(short.isInline());
+    try std.testing.expect(!short.isOwned());
+    try std.testing.expectEqualStrings("user_id", short.slice());
+
+    const full = IdrisString.initInline("a" ** IdrisString.inline_capacity);
+    try std.testing.expectEqual(IdrisString.inline_capacity, full.length());
+
+    const text = "not copied";
+    const borrowed = IdrisString.borrowed(text);
+    try std.testing.expect(borrowed.isBorrowed());
+    try std.testing.expect(borrowed.ownedBytes() == null);
+    try std.testing.expectEqual(@as([*]const u8, text), borrowed.slice().ptr);
+    try std.testing.expectEqual(text.len, borrowed.length());
 }
 
 test "IdrisMaybe layout" {
@@ -230,9 +645,97 @@ test "IdrisMaybe layout" {
     try std.testing.expect(just.value == 42);
 }
 
+test "gc roots are generation checked" {
+    const a = try gcRoot(.{ .int = 42 });
+    try std.testing.expectEqual(@as(i64, 42), gcGet(a).?.int);
+    try std.testing.expectEqual(@as(usize, 1), gcRootCount());
+
+    gcUnroot(a);
+    try std.testing.expect(gcGet(a) == null);
+    gcUnroot(a); // stale handle: ignored
+
+    // The slot is reused, but the old handle still misses
+    const b = try gcRoot(.{ .int = 7 });
+    defer gcUnroot(b);
+    try std.testing.expect(a != b);
+    try std.testing.expect(gcGet(a) == null);
+    try std.testing.expectEqual(@as(i64, 7), gcGet(b).?.int);
+}
+
+test "gc object roots queue their release for gcCollect" {
+    const FakeRefc = struct {
+        var count: i32 = 0;
+
+        fn retain(obj: *anyopaque) callconv(.C) void {
+            _ = obj;
+            count += 1;
+        }
+
+        fn release(obj: *anyopaque) callconv(.C) void {
+            _ = obj;
+            count -= 1;
+        }
+    };
+
+    var buffer = [_]u8{ 1, 2, 3 };
+    gcSetRefcHooks(null);
+    if (refc.default == null) {
+        try std.testing.expectError(error.RefcUnavailable, gcRootObject(&buffer));
+    }
+
+    gcSetRefcHooks(.{ .retain = FakeRefc.retain, .release = FakeRefc.release });
+    defer gcSetRefcHooks(null);
+    const h = try gcRootObject(&buffer);
+    try std.testing.expectEqual(@as(?*anyopaque, &buffer), gcGetObject(h));
+    try std.testing.expectEqual(@as(i32, 1), FakeRefc.count);
+
+    gcUnroot(h);
+    try std.testing.expect(gcGetObject(h) == null);
+    try std.testing.expectEqual(@as(i32, 1), FakeRefc.count);
+    try std.testing.expectEqual(@as(usize, 1), gcCollect());
+    try std.testing.expectEqual(@as(i32, 0), FakeRefc.count);
+    try std.testing.expectEqual(@as(usize, 0), gcCollect());
+}
+
 test "runtime initialization" {
     try initRuntime();
     try std.testing.expect(isInitialized());
     deinitRuntime();
     try std.testing.expect(!isInitialized());
 }
+
+test "concurrent init and per-thread handles" {
+    if (builtin.single_threaded) return error.SkipZigTest;
+
+    const Worker = struct {
+        fn run(failures: *std.atomic.Value(u32)) void {
+            const handle = attachThread() catch {
+                _ = failures.fetchAdd(1, .monotonic);
+                return;
+            };
+            defer detachThread();
+            if (!isInitialized()) _ = failures.fetchAdd(1, .monotonic);
+
+            // Each thread bumps its own scratch; nothing is shared
+            const mark = handle.scratch.mark();
+            defer handle.scratch.restore(mark);
+            for (0..100) |i| {
+                const bytes = handle.scratch.alloc(u8, 64) catch {
+                    _ = failures.fetchAdd(1, .monotonic);
+                    return;
+                };
+                @memset(bytes, @truncate(i));
+            }
+        }
+    };
+
+    var failures = std.atomic.Value(u32).init(0);
+    var threads: [8]std.Thread = undefined;
+    for (&threads) |*t| t.* = try std.Thread.spawn(.{}, Worker.run, .{&failures});
+    for (threads) |t| t.join();
+
+    try std.testing.expectEqual(@as(u32, 0), failures.load(.monotonic));
+    try std.testing.expect(isInitialized());
+    try std.testing.expectEqual(@as(u32, 0), attachedThreadCount());
+    deinitRuntime();
+}
@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: Palimpsest-MPL-1.0
+//! Array kernels for typed homogeneous arrays
+//!
+//! Reductions (sum, min, max, dot) and elementwise maps over i64, f64 and
+//! u8 slices. Loops are written over @Vector chunks sized for the target,
+//! so they compile to SIMD where available and to plain loops elsewhere.
+//! Integer arithmetic wraps; u8 reductions accumulate in u64.
+
+const std = @import("std");
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+/// Accumulator type for reductions over T
+pub fn Acc(comptime T: type) type {
+    return if (T == u8) u64 else T;
+}
+
+fn lanes(comptime T: type) comptime_int {
+    return std.simd.suggestVectorLength(T) orelse 1;
+}
+
+fn isFloat(comptime T: type) bool {
+    return @typeInfo(T) == .Float;
+}
+
+/// Load `n` elements starting at `i` as a vector of A
+inline fn load(comptime T: type, comptime A: type, comptime n: comptime_int, xs: []const T, i: usize) @Vector(n, A) {
+    const chunk: @Vector(n, T) = xs[i..][0..n].*;
+    if (T == A) return chunk;
+    return @intCast(chunk);
+}
+
+inline fn add(comptime T: type, a: anytype, b: @TypeOf(a)) @TypeOf(a) {
+    return if (comptime isFloat(T)) a + b else a +% b;
+}
+
+inline fn sub(comptime T: type, a: anytype, b: @TypeOf(a)) @TypeOf(a) {
+    return if (comptime isFloat(T)) a - b else a -% b;
+}
+
+inline fn mul(comptime T: type, a: anytype, b: @TypeOf(a)) @TypeOf(a) {
+    return if (comptime isFloat(T)) a * b else a *% b;
+}
+
+// ============================================================================
+// Reductions
+// ============================================================================
+
+/// Sum of all elements (0 for an empty slice)
+pub fn sum(comptime T: type, xs: []const T) Acc(T) {
+    const A = Acc(T);
+    const n = lanes(A);
+
+    var acc: @Vector(n, A) = @splat(0);
+    var i: usize = 0;
+    while (i + n <= xs.len) : (i += n) {
+        acc = add(A, acc, load(T, A, n, xs, i));
+    }
+
+    var total: A = @reduce(.Add, acc);
+    while (i < xs.len) : (i += 1) {
+        total = add(A, total, @as(A, xs[i]));
+    }
+    return total;
+}
+
+/// Dot product of two slices of equal length
+pub fn dot(comptime T: type, xs: []const T, ys: []const T) Acc(T) {
+    std.debug.assert(xs.len == ys.len);
+    const A = Acc(T);
+    const n = lanes(A);
+
+    var acc: @Vector(n, A) = @splat(0);
+    var i: usize = 0;
+    while (i + n <= xs.len) : (i += n) {
+        acc = add(A, acc, mul(A, load(T, A, n, xs, i), load(T, A, n, ys, i)));
+    }
+
+    var total: A = @reduce(.Add, acc);
+    while (i < xs.len) : (i += 1) {
+        total = add(A, total, mul(A, @as(A, xs[i]), @as(A, ys[i])));
+    }
+    return total;
+}
+
+const Extremum = enum { min, max };
+
+fn extremum(comptime T: type, comptime which: Extremum, xs: []const T) ?T {
+    if (xs.len == 0) return null;
+    const n = lanes(T);
+    const op: std.builtin.ReduceOp = if (which == .min) .Min else .Max;
+
+    var best: T = xs[0];
+    var i: usize = 0;
+    if (xs.len >= n) {
+        var acc: @Vector(n, T) = xs[0..n].*;
+        i = n;
+        while (i + n <= xs.len) : (i += n) {
+            const chunk: @Vector(n, T) = xs[i..][0..n].*;
+            acc = if (which == .min) @min(acc, chunk) else @max(acc, chunk);
+        }
+        best = @reduce(op, acc);
+    }
+    while (i < xs.len) : (i += 1) {
+        best = if (which == .min) @min(best, xs[i]) else @max(best, xs[i]);
+    }
+    return best;
+}
+
+/// Smallest element, or null for an empty slice
+pub fn min(comptime T: type, xs: []const T) ?T {
+    return extremum(T, .min, xs);
+}
+
+/// Largest element, or null for an empty slice
+pub fn max(comptime T: type, xs: []const T) ?T {
+    return extremum(T, .max, xs);
+}
+
+// ============================================================================
+// Elementwise Maps
+// ============================================================================
+
+/// Binary elementwise operations
+pub const BinaryOp = enum { add, sub, mul };
+
+/// dst[i] = a[i] `op` b[i]. dst may alias a or b.
+pub fn map2(comptime T: type, comptime op: BinaryOp, dst: []T, a: []const T, b: []const T) void {
+    std.debug.assert(dst.len == a.len and dst.len == b.len);
+    const n = lanes(T);
+
+    var i: usize = 0;
+    while (i + n <= dst.len) : (i += n) {
+        const va = load(T, T, n, a, i);
+        const vb = load(T, T, n, b, i);
+        dst[i..][0..n].* = apply(T, op, va, vb);
+    }
+    while (i < dst.len) : (i += 1) {
+        dst[i] = apply(T, op, a[i], b[i]);
+    }
+}
+
+/// dst[i] = src[i] `op` k. dst may alias src.
+pub fn mapScalar(comptime T: type, comptime op: BinaryOp, dst: []T, src: []const T, k: T) void {
+    std.debug.assert(dst.len == src.len);
+    const n = lanes(T);
+    const vk: @Vector(n, T) = @splat(k);
+
+    var i: usize = 0;
+    while (i + n <= dst.len) : (i += n) {
+        dst[i..][0..n].* = apply(T, op, load(T, T, n, src, i), vk);
+    }
+    while (i < dst.len) : (i += 1) {
+        dst[i] = apply(T, op, src[i], k);
+    }
+}
+
+inline fn apply(comptime T: type, comptime op: BinaryOp, a: anytype, b: @TypeOf(a)) @TypeOf(a) {
+    return switch (op) {
+        .add => add(T, a, b),
+        .sub => sub(T, a, b),
+        .mul => mul(T, a, b),
+    };
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "reductions match scalar loops" {
+    var xs: [37]i64 = undefined;
+    var ys: [37]i64 = undefined;
+    var expected_sum: i64 = 0;
+    var expected_dot: i64 = 0;
+    for (&xs, &ys, 0..) |*x, *y, i| {
+        x.* = @as(i64, @intCast(i)) - 10;
+        y.* = 2;
+        expected_sum += x.*;
+        expected_dot += x.* * 2;
+    }
+
+    try std.testing.expectEqual(expected_sum, sum(i64, &xs));
+    try std.testing.expectEqual(expected_dot, dot(i64, &xs, &ys));
+    try std.testing.expectEqual(@as(?i64, -10), min(i64, &xs));
+    try std.testing.expectEqual(@as(?i64, 26), max(i64, &xs));
+    try std.testing.expectEqual(@as(?i64, null), min(i64, &[_]i64{}));
+}
+
+test "u8 sums widen" {
+    const bytes = [_]u8{255} ** 100;
+    try std.testing.expectEqual(@as(u64, 25500), sum(u8, &bytes));
+    try std.testing.expectEqual(@as(u64, 255 * 255 * 100), dot(u8, &bytes, &bytes));
+}
+
+test "elementwise maps" {
+    const a = [_]f64{ 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    var out: [9]f64 = undefined;
+
+    map2(f64, .add, &out, &a, &a);
+    try std.testing.expectEqual(@as(f64, 18), out[8]);
+
+    mapScalar(f64, .mul, &out, &out, 0.5);
+    try std.testing.expectEqualSlices(f64, &a, &out);
+}
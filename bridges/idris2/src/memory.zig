@@ -5,13 +5,114 @@
 //! the Idris 2 runtime garbage collector.
 
 const std = @import("std");
+const builtin = @import("builtin");
+const build_options = @import("build_options");
 const idris_rts = @import("idris_rts.zig");
 
-/// Global allocator for FFI bridge
-/// Uses the general purpose allocator for now, but can be swapped
-/// for a custom allocator that integrates with Idris GC
+/// Allocator backend chosen at build time (-Dallocator=gpa|c|page).
+/// Debug builds default to the safety-checking GPA; release builds default
+/// to libc malloc so FFI traffic is not serialised on the GPA mutex.
+pub const backend = build_options.allocator;
+
 var gpa = std.heap.GeneralPurposeAllocator(.{}){};
-pub const allocator = gpa.allocator();
+
+/// Backend allocator before optional statistics counting
+const backend_allocator: std.mem.Allocator = switch (backend) {
+    .gpa => gpa.allocator(),
+    .c => if (builtin.link_libc)
+        std.heap.c_allocator
+    else
+        @compileError("-Dallocator=c requires linking libc"),
+    .page => std.heap.page_allocator,
+    .wasm => if (builtin.target.isWasm())
+        std.heap.wasm_allocator
+    else
+        @compileError("-Dallocator=wasm is only available on WASM targets"),
+};
+
+/// Whether allocations are counted (-Dalloc-stats, always on for `zig build bench`)
+pub const stats_enabled = build_options.alloc_stats;
+
+var counting: CountingAllocator = .{ .child = backend_allocator };
+
+/// Global allocator for FFI bridge
+pub const allocator: std.mem.Allocator = if (stats_enabled) counting.allocator() else backend_allocator;
+
+// ============================================================================
+// Allocation Statistics
+// ============================================================================
+
+/// Totals since start-up or the last resetAllocStats (all zero unless
+/// stats are enabled)
+pub const AllocStats = struct {
+    allocs: u64 = 0,
+    frees: u64 = 0,
+    resizes: u64 = 0,
+    bytes_allocated: u64 = 0,
+};
+
+/// Wraps an allocator and counts calls with relaxed atomics
+const CountingAllocator = struct {
+    child: std.mem.Allocator,
+    allocs: std.atomic.Value(u64) = std.atomic.Value(u64).init(0),
+    frees: std.atomic.Value(u64) = std.atomic.Value(u64).init(0),
+    resizes: std.atomic.Value(u64) = std.atomic.Value(u64).init(0),
+    bytes: std.atomic.Value(u64) = std.atomic.Value(u64).init(0),
+
+    fn allocator(self: *CountingAllocator) std.mem.Allocator {
+        return .{
+            .ptr = self,
+            .vtable = &.{ .alloc = alloc_, .resize = resize_, .free = free_ },
+        };
+    }
+
+    fn alloc_(ctx: *anyopaque, len: usize, ptr_align: u8, ret_addr: usize) ?[*]u8 {
+        const self: *CountingAllocator = @ptrCast(@alignCast(ctx));
+        const ptr = self.child.rawAlloc(len, ptr_align, ret_addr) orelse return null;
+        _ = self.allocs.fetchAdd(1, .monotonic);
+        _ = self.bytes.fetchAdd(len, .monotonic);
+        return ptr;
+    }
+
+    fn resize_(ctx: *anyopaque, buf: []u8, buf_align: u8, new_len: usize, ret_addr: usize) bool {
+        const self: *CountingAllocator = @ptrCast(@alignCast(ctx));
+        if (!self.child.rawResize(buf, buf_align, new_len, ret_addr)) return false;
+        _ = self.resizes.fetchAdd(1, .monotonic);
+        if (new_len > buf.len) _ = self.bytes.fetchAdd(new_len - buf.len, .monotonic);
+        return true;
+    }
+
+    fn free_(ctx: *anyopaque, buf: []u8, buf_align: u8, ret_addr: usize) void {
+        const self: *CountingAllocator = @ptrCast(@alignCast(ctx));
+        self.child.rawFree(buf, buf_align, ret_addr);
+        _ = self.frees.fetchAdd(1, .monotonic);
+    }
+};
+
+/// Current allocation counters
+pub fn allocStats() AllocStats {
+    if (!stats_enabled) return .{};
+    return .{
+        .allocs = counting.allocs.load(.monotonic),
+        .frees = counting.frees.load(.monotonic),
+        .resizes = counting.resizes.load(.monotonic),
+        .bytes_allocated = counting.bytes.load(.monotonic),
+    };
+}
+
+/// Zero the allocation counters
+pub fn resetAllocStats() void {
+    if (!stats_enabled) return;
+    counting.allocs.store(0, .monotonic);
+    counting.frees.store(0, .monotonic);
+    counting.resizes.store(0, .monotonic);
+    counting.bytes.store(0, .monotonic);
+}
+
+/// Whether leak and double-free checking is active
+pub fn isCheckedAllocator() bool {
+    return backend == .gpa;
+}
 
 /// Allocate memory for a slice of T
 pub fn alloc(comptime T: type, count: usize) ![]T {
@@ -23,49 +124,479 @@ pub fn free(ptr: anytype) void {
     allocator.free(ptr);
 }
 
-/// Raw allocation for C interop
+// ============================================================================
+// Raw Allocation (size-tracked, for C/Idris callers that only keep a pointer)
+// ============================================================================
+
+/// Header stored immediately before every allocRaw pointer
+const RawHeader = extern struct {
+    /// Requested size in bytes
+    size: usize,
+    /// Allocation sequence number, for telling reused blocks apart
+    generation: u32,
+    /// Distance from the start of the underlying block to the user pointer
+    offset: u16,
+    /// log2 of the alignment the block was allocated with
+    align_log2: u8,
+    state: u8,
+};
+
+/// Minimum alignment of allocRaw pointers (matches C max_align_t)
+pub const raw_min_align: usize = 16;
+
+const raw_state_live: u8 = 0xA1;
+const raw_state_freed: u8 = 0xFD;
+
+/// Small blocks (header + payload, rounded to a power of two) are recycled
+/// through per-thread caches instead of going back to the allocator
+const raw_class_shift_min = 5; // 32 bytes
+const raw_class_shift_max = 10; // 1 KiB
+const raw_class_count = raw_class_shift_max - raw_class_shift_min + 1;
+
+/// Blocks kept per class per thread before frees go back to the allocator
+const raw_cache_limit = 64;
+
+const RawFreeBlock = struct {
+    next: ?*RawFreeBlock,
+};
+
+const RawCache = struct {
+    heads: [raw_class_count]?*RawFreeBlock = [_]?*RawFreeBlock{null} ** raw_class_count,
+    counts: [raw_class_count]u16 = [_]u16{0} ** raw_class_count,
+};
+
+threadlocal var raw_cache: RawCache = .{};
+var raw_generation = std.atomic.Value(u32).init(0);
+
+fn rawHeader(ptr: *anyopaque) *RawHeader {
+    return @ptrFromInt(@intFromPtr(ptr) - @sizeOf(RawHeader));
+}
+
+/// Size class for a block, or null if it must go straight to the allocator
+fn rawClass(total: usize, align_log2: u8) ?usize {
+    if (@as(usize, 1) << @intCast(align_log2) != raw_min_align) return null;
+    if (total > (1 << raw_class_shift_max)) return null;
+    const shift = @max(std.math.log2_int_ceil(usize, total), raw_class_shift_min);
+    return shift - raw_class_shift_min;
+}
+
+fn rawClassSize(class: usize) usize {
+    return @as(usize, 1) << @intCast(class + raw_class_shift_min);
+}
+
+fn allocBlock(total: usize, align_log2: u8) ?[*]u8 {
+    if (rawClass(total, align_log2)) |class| {
+        if (raw_cache.heads[class]) |block| {
+            raw_cache.heads[class] = block.next;
+            raw_cache.counts[class] -= 1;
+            return @ptrCast(block);
+        }
+        return allocator.rawAlloc(rawClassSize(class), align_log2, @returnAddress());
+    }
+    return allocator.rawAlloc(total, align_log2, @returnAddress());
+}
+
+fn freeBlock(block: [*]u8, total: usize, align_log2: u8) void {
+    if (rawClass(total, align_log2)) |class| {
+        if (raw_cache.counts[class] < raw_cache_limit) {
+            const node: *RawFreeBlock = @ptrCast(@alignCast(block));
+            node.next = raw_cache.heads[class];
+            raw_cache.heads[class] = node;
+            raw_cache.counts[class] += 1;
+            return;
+        }
+        allocator.rawFree(block[0..rawClassSize(class)], align_log2, @returnAddress());
+        return;
+    }
+    allocator.rawFree(block[0..total], align_log2, @returnAddress());
+}
+
+/// Raw allocation for C interop, aligned to raw_min_align.
+/// Release with freeRaw; the size is tracked internally.
 pub fn allocRaw(size: usize) ?*anyopaque {
-    const slice = allocator.alloc(u8, size) catch return null;
-    return slice.ptr;
+    return allocRawAligned(size, raw_min_align);
+}
+
+/// Raw allocation with an explicit power-of-two alignment
+pub fn allocRawAligned(size: usize, alignment: usize) ?*anyopaque {
+    if (!std.math.isPowerOfTwo(alignment)) return null;
+
+    const block_align = @max(alignment, raw_min_align);
+    const align_log2: u8 = std.math.log2_int(usize, block_align);
+    const offset = std.mem.alignForward(usize, @sizeOf(RawHeader), block_align);
+    if (offset > std.math.maxInt(u16)) return null;
+    const total = std.math.add(usize, offset, size) catch return null;
+
+    const block = allocBlock(total, align_log2) orelse return null;
+    const user: *anyopaque = @ptrCast(block + offset);
+    rawHeader(user).* = .{
+        .size = size,
+        .generation = raw_generation.fetchAdd(1, .monotonic),
+        .offset = @intCast(offset),
+        .align_log2 = align_log2,
+        .state = raw_state_live,
+    };
+    return user;
 }
 
-/// Raw free for C interop
+/// Raw free for C interop. Accepts only pointers from allocRaw/allocRawAligned.
 pub fn freeRaw(ptr: ?*anyopaque) void {
-    if (ptr) |p| {
-        // We need to know the size to free properly
-        // For now, this is a limitation - in production, we'd track allocations
-        _ = p;
+    const p = ptr orelse return;
+    const header = rawHeader(p);
+    if (header.state != raw_state_live) {
+        if (std.debug.runtime_safety) @panic("freeRaw: double free or foreign pointer");
+        return;
+    }
+    header.state = raw_state_freed;
+
+    const block: [*]u8 = @ptrFromInt(@intFromPtr(p) - header.offset);
+    freeBlock(block, header.offset + header.size, header.align_log2);
+}
+
+/// Size requested for a live allocRaw pointer
+pub fn rawSize(ptr: *anyopaque) usize {
+    return rawHeader(ptr).size;
+}
+
+/// Generation (allocation sequence number) of a live allocRaw pointer
+pub fn rawGeneration(ptr: *anyopaque) u32 {
+    return rawHeader(ptr).generation;
+}
+
+/// Return this thread's cached raw blocks to the allocator.
+/// Call before a thread that used allocRaw exits.
+pub fn flushThreadCache() void {
+    for (&raw_cache.heads, &raw_cache.counts, 0..) |*head, *count, class| {
+        while (head.*) |block| {
+            head.* = block.next;
+            const bytes: [*]u8 = @ptrCast(block);
+            allocator.rawFree(bytes[0..rawClassSize(class)], std.math.log2_int(usize, raw_min_align), @returnAddress());
+        }
+        count.* = 0;
+    }
+}
+
+// ============================================================================
+// Growable Byte Buffers (idris2_alloc / idris2_realloc / idris2_free)
+// ============================================================================
+
+/// Whether large byte buffers get their own page mappings, which mremap
+/// can grow without copying. Linux only; elsewhere every size goes
+/// through `allocator`.
+pub const large_blocks_enabled = builtin.os.tag == .linux;
+
+/// Buffers of at least this many bytes are mapped directly. Callers pass
+/// the size back on free/realloc, so the size alone decides which path a
+/// buffer took.
+pub const large_block_threshold = 256 * 1024;
+
+/// Buffers from this size up are advised as huge-page candidates when
+/// huge pages are enabled (one x86-64/aarch64 PMD)
+pub const huge_page_size = 2 * 1024 * 1024;
+
+var huge_pages = std.atomic.Value(bool).init(false);
+
+/// Turn transparent huge page advice (MADV_HUGEPAGE) on or off for large
+/// buffers mapped from now on
+pub fn setHugePages(enabled: bool) void {
+    huge_pages.store(enabled, .monotonic);
+}
+
+fn isLarge(size: usize) bool {
+    return large_blocks_enabled and size >= large_block_threshold;
+}
+
+fn adviseHuge(bytes: []u8) void {
+    if (!large_blocks_enabled or !huge_pages.load(.monotonic)) return;
+    if (bytes.len < huge_page_size) return;
+    const len = std.mem.alignForward(usize, bytes.len, std.mem.page_size);
+    _ = std.os.linux.madvise(bytes.ptr, len, std.os.linux.MADV.HUGEPAGE);
+}
+
+/// Allocate a byte buffer; release with freeBytes(ptr, size)
+pub fn allocBytes(size: usize) ?[*]u8 {
+    if (isLarge(size)) {
+        const bytes = std.heap.page_allocator.alloc(u8, size) catch return null;
+        adviseHuge(bytes);
+        return bytes.ptr;
+    }
+    const bytes = allocator.alloc(u8, size) catch return null;
+    return bytes.ptr;
+}
+
+/// Free a buffer from allocBytes/reallocBytes; `size` is its current size
+pub fn freeBytes(ptr: [*]u8, size: usize) void {
+    if (isLarge(size)) {
+        std.heap.page_allocator.free(ptr[0..size]);
+    } else {
+        allocator.free(ptr[0..size]);
+    }
+}
+
+/// Resize a buffer. Large buffers grow with mremap, which moves page
+/// table entries instead of copying bytes, so growing a buffer
+/// repeatedly is linear overall rather than quadratic. Small buffers use
+/// the allocator's realloc; buffers crossing the threshold are copied once.
+pub fn reallocBytes(ptr: [*]u8, old_size: usize, new_size: usize) ?[*]u8 {
+    const old_large = isLarge(old_size);
+    const new_large = isLarge(new_size);
+
+    if (old_large and new_large) {
+        if (remap(ptr, old_size, new_size)) |p| return p;
+    } else if (!old_large and !new_large) {
+        const bytes = allocator.realloc(ptr[0..old_size], new_size) catch return null;
+        return bytes.ptr;
+    }
+
+    const new_ptr = allocBytes(new_size) orelse return null;
+    @memcpy(new_ptr[0..@min(old_size, new_size)], ptr[0..@min(old_size, new_size)]);
+    freeBytes(ptr, old_size);
+    return new_ptr;
+}
+
+fn remap(ptr: [*]u8, old_size: usize, new_size: usize) ?[*]u8 {
+    if (!large_blocks_enabled) return null;
+    const linux = std.os.linux;
+    const old_len = std.mem.alignForward(usize, old_size, std.mem.page_size);
+    const new_len = std.mem.alignForward(usize, new_size, std.mem.page_size);
+    if (old_len == new_len) return ptr;
+
+    const MREMAP_MAYMOVE = 1;
+    const rc = linux.syscall5(.mremap, @intFromPtr(ptr), old_len, new_len, MREMAP_MAYMOVE, 0);
+    if (linux.E.init(rc) != .SUCCESS) return null;
+    const new_ptr: [*]u8 = @ptrFromInt(rc);
+    if (new_size > old_size) adviseHuge(new_ptr[0..new_size]);
+    return new_ptr;
+}
+
+/// Suggested capacity for a buffer that must hold at least `needed` bytes
+/// and currently holds `current`. Grows by 1.5x (at least to `needed`), so
+/// appends are amortised O(1). Large sizes are rounded to whole pages, and
+/// to huge pages once huge-page advice is on.
+pub fn growCapacity(current: usize, needed: usize) usize {
+    if (needed <= current) return current;
+    const geometric = current +| current / 2;
+    var capacity = @max(needed, geometric, 64);
+    if (isLarge(capacity)) {
+        const unit: usize = if (huge_pages.load(.monotonic) and capacity >= huge_page_size)
+            huge_page_size
+        else
+            std.mem.page_size;
+        capacity = std.mem.alignForward(usize, capacity, unit);
     }
+    return capacity;
 }
 
-/// Free an Idris string
+/// Free an Idris string (no-op for inline and borrowed strings)
 pub fn freeIdrisString(str: idris_rts.IdrisString) void {
-    if (str.data) |data| {
-        const slice: []u8 = @ptrCast(data[0..str.len]);
-        allocator.free(slice);
+    if (str.ownedBytes()) |bytes| {
+        allocator.free(bytes);
+    }
+}
+
+// ============================================================================
+// Object Pools
+// ============================================================================
+
+/// Target slab size for pools; each slab holds at least 16 slots
+const pool_slab_bytes: usize = 16 * 1024;
+
+const SlotFree = struct {
+    next: ?*SlotFree,
+};
+
+/// Slab-backed store of fixed-size slots with an intrusive free list.
+/// Shared engine behind Pool and TypedPool.
+const SlotPool = struct {
+    backing: std.mem.Allocator,
+    slot_size: usize,
+    align_log2: u8,
+    slots_per_slab: usize,
+    slabs: std.ArrayListUnmanaged([*]u8) = .{},
+    free_list: ?*SlotFree = null,
+    /// Next slab/slot to carve when the free list is empty
+    slab_index: usize = 0,
+    cursor: usize = 0,
+    live: usize = 0,
+
+    fn init(backing: std.mem.Allocator, size: usize, alignment: usize) SlotPool {
+        const slot_align = @max(alignment, @alignOf(SlotFree));
+        const slot_size = std.mem.alignForward(usize, @max(size, @sizeOf(SlotFree)), slot_align);
+        return .{
+            .backing = backing,
+            .slot_size = slot_size,
+            .align_log2 = std.math.log2_int(usize, slot_align),
+            .slots_per_slab = @max(16, pool_slab_bytes / slot_size),
+        };
+    }
+
+    fn slabBytes(self: *const SlotPool) usize {
+        return self.slot_size * self.slots_per_slab;
+    }
+
+    fn take(self: *SlotPool) ?*anyopaque {
+        if (self.free_list) |node| {
+            self.free_list = node.next;
+            self.live += 1;
+            return node;
+        }
+
+        if (self.slab_index == self.slabs.items.len) {
+            const slab = self.backing.rawAlloc(self.slabBytes(), self.align_log2, @returnAddress()) orelse return null;
+            self.slabs.append(self.backing, slab) catch {
+                self.backing.rawFree(slab[0..self.slabBytes()], self.align_log2, @returnAddress());
+                return null;
+            };
+        }
+
+        const slot = self.slabs.items[self.slab_index] + self.cursor * self.slot_size;
+        self.cursor += 1;
+        if (self.cursor == self.slots_per_slab) {
+            self.slab_index += 1;
+            self.cursor = 0;
+        }
+        self.live += 1;
+        return slot;
+    }
+
+    fn put(self: *SlotPool, ptr: *anyopaque) void {
+        const node: *SlotFree = @ptrCast(@alignCast(ptr));
+        node.next = self.free_list;
+        self.free_list = node;
+        self.live -= 1;
+    }
+
+    /// Drop every object at once; slabs are kept and re-carved from the start
+    fn reset(self: *SlotPool) void {
+        self.free_list = null;
+        self.slab_index = 0;
+        self.cursor = 0;
+        self.live = 0;
+    }
+
+    fn deinit(self: *SlotPool) void {
+        for (self.slabs.items) |slab| {
+            self.backing.rawFree(slab[0..self.slabBytes()], self.align_log2, @returnAddress());
+        }
+        self.slabs.deinit(self.backing);
+        self.* = undefined;
     }
+};
+
+/// Slab-backed pool for a single type (IdrisValue, IdrisConstructor,
+/// list nodes, ...). create/destroy are a free-list pop/push; reset
+/// releases every object in O(1) while keeping the slabs.
+/// Not thread-safe; use threadPool for a per-thread instance.
+pub fn TypedPool(comptime T: type) type {
+    return struct {
+        slots: SlotPool,
+
+        const Self = @This();
+
+        pub fn init() Self {
+            return initWith(allocator);
+        }
+
+        pub fn initWith(backing: std.mem.Allocator) Self {
+            return .{ .slots = SlotPool.init(backing, @sizeOf(T), @alignOf(T)) };
+        }
+
+        pub fn deinit(self: *Self) void {
+            self.slots.deinit();
+        }
+
+        pub fn create(self: *Self) !*T {
+            const slot = self.slots.take() orelse return error.OutOfMemory;
+            return @ptrCast(@alignCast(slot));
+        }
+
+        pub fn destroy(self: *Self, ptr: *T) void {
+            self.slots.put(ptr);
+        }
+
+        pub fn reset(self: *Self) void {
+            self.slots.reset();
+        }
+
+        /// Number of objects currently handed out
+        pub fn liveCount(self: *const Self) usize {
+            return self.slots.live;
+        }
+    };
+}
+
+fn ThreadPoolHolder(comptime T: type) type {
+    return struct {
+        threadlocal var pool: ?TypedPool(T) = null;
+    };
+}
+
+/// Per-thread pool for T, created on first use. Objects must be destroyed
+/// on the thread that created them.
+pub fn threadPool(comptime T: type) *TypedPool(T) {
+    const Holder = ThreadPoolHolder(T);
+    if (Holder.pool == null) Holder.pool = TypedPool(T).init();
+    return &Holder.pool.?;
+}
+
+/// Free this thread's pool for T. Call before the thread exits.
+pub fn releaseThreadPool(comptime T: type) void {
+    const Holder = ThreadPoolHolder(T);
+    if (Holder.pool) |*pool| pool.deinit();
+    Holder.pool = null;
 }
 
-/// Memory pool for frequently allocated types
+/// Size classes served by Pool (16-byte steps up to 256 bytes, 16-aligned)
+const pool_class_step = 16;
+const pool_class_max = 256;
+const pool_class_count = pool_class_max / pool_class_step;
+
+/// Memory pool for frequently allocated types. Types up to 256 bytes with
+/// alignment <= 16 share slab-backed free lists by size class; anything
+/// larger falls through to the backing allocator.
 pub const Pool = struct {
     allocator: std.mem.Allocator,
+    classes: [pool_class_count]SlotPool,
 
     pub fn init() Pool {
-        return .{ .allocator = allocator };
+        var pool = Pool{ .allocator = allocator, .classes = undefined };
+        for (&pool.classes, 0..) |*class, i| {
+            class.* = SlotPool.init(allocator, (i + 1) * pool_class_step, pool_class_step);
+        }
+        return pool;
     }
 
     pub fn deinit(self: *Pool) void {
-        _ = self;
-        // Cleanup pool resources
+        for (&self.classes) |*class| class.deinit();
+    }
+
+    fn classOf(comptime T: type) ?usize {
+        if (@sizeOf(T) == 0 or @sizeOf(T) > pool_class_max) return null;
+        if (@alignOf(T) > pool_class_step) return null;
+        return (@sizeOf(T) - 1) / pool_class_step;
     }
 
     pub fn create(self: *Pool, comptime T: type) !*T {
+        if (comptime classOf(T)) |class| {
+            const slot = self.classes[class].take() orelse return error.OutOfMemory;
+            return @ptrCast(@alignCast(slot));
+        }
         return try self.allocator.create(T);
     }
 
     pub fn destroy(self: *Pool, ptr: anytype) void {
+        const T = @typeInfo(@TypeOf(ptr)).Pointer.child;
+        if (comptime classOf(T)) |class| {
+            self.classes[class].put(@ptrCast(ptr));
+            return;
+        }
         self.allocator.destroy(ptr);
     }
+
+    /// Release every pooled object at once (large objects are unaffected)
+    pub fn reset(self: *Pool) void {
+        for (&self.classes) |*class| class.reset();
+    }
 };
 
 /// RAII wrapper for automatic cleanup
@@ -115,6 +646,174 @@ pub const Arena = struct {
     }
 };
 
+// ============================================================================
+// Scratch (per-thread bump allocator with save points)
+// ============================================================================
+
+/// Global allocator under another name (Scratch has its own `allocator`)
+const scratch_backing = allocator;
+
+/// Bump allocator for short-lived data such as marshalled call arguments.
+/// Chunks are kept between uses. `mark`/`restore` rewind like a stack, so
+/// nested scopes (a call made from inside a callback) release only their
+/// own data. Not thread-safe; each thread owns one (idris_rts.ThreadHandle).
+pub const Scratch = struct {
+    first: ?*Chunk = null,
+    current: ?*Chunk = null,
+
+    /// Smallest chunk requested from the allocator
+    pub const min_chunk = 16 * 1024;
+
+    const Chunk = struct {
+        next: ?*Chunk,
+        capacity: usize,
+        used: usize,
+
+        fn bytes(self: *Chunk) [*]u8 {
+            return @as([*]u8, @ptrCast(self)) + @sizeOf(Chunk);
+        }
+
+        fn block(self: *Chunk) []align(@alignOf(Chunk)) u8 {
+            const base: [*]align(@alignOf(Chunk)) u8 = @ptrCast(self);
+            return base[0 .. @sizeOf(Chunk) + self.capacity];
+        }
+    };
+
+    /// Position to rewind to
+    pub const Mark = struct {
+        chunk: ?*Chunk,
+        used: usize,
+    };
+
+    pub fn mark(self: *const Scratch) Mark {
+        const chunk = self.current orelse return .{ .chunk = null, .used = 0 };
+        return .{ .chunk = chunk, .used = chunk.used };
+    }
+
+    /// Release everything allocated since `m` (memory is kept for reuse)
+    pub fn restore(self: *Scratch, m: Mark) void {
+        const chunk = m.chunk orelse self.first orelse return;
+        chunk.used = m.used;
+        self.current = chunk;
+    }
+
+    /// Release everything (memory is kept for reuse)
+    pub fn reset(self: *Scratch) void {
+        self.restore(.{ .chunk = null, .used = 0 });
+    }
+
+    /// Allocate `len` bytes aligned to `alignment`
+    pub fn allocBytes(self: *Scratch, len: usize, alignment: usize) ?[*]u8 {
+        if (self.current) |chunk| {
+            if (bump(chunk, len, alignment)) |p| return p;
+            // Chunks past `current` are free; reuse the next one if it fits
+            if (chunk.next) |next| {
+                next.used = 0;
+                if (bump(next, len, alignment)) |p| {
+                    self.current = next;
+                    return p;
+                }
+            }
+        }
+        const chunk = self.addChunk(len + alignment) orelse return null;
+        return bump(chunk, len, alignment);
+    }
+
+    pub fn alloc(self: *Scratch, comptime T: type, count: usize) ![]T {
+        const p = self.allocBytes(@sizeOf(T) * count, @alignOf(T)) orelse return error.OutOfMemory;
+        return @as([*]T, @ptrCast(@alignCast(p)))[0..count];
+    }
+
+    pub fn dupe(self: *Scratch, bytes: []const u8) ![]u8 {
+        const copy = try self.alloc(u8, bytes.len);
+        @memcpy(copy, bytes);
+        return copy;
+    }
+
+    /// std.mem.Allocator view (free/resize only act on the latest block)
+    pub fn allocator(self: *Scratch) std.mem.Allocator {
+        return .{
+            .ptr = self,
+            .vtable = &.{ .alloc = alloc_, .resize = resize_, .free = free_ },
+        };
+    }
+
+    /// Bytes reserved from the backing allocator
+    pub fn capacity(self: *const Scratch) usize {
+        var total: usize = 0;
+        var it = self.first;
+        while (it) |chunk| : (it = chunk.next) total += chunk.capacity;
+        return total;
+    }
+
+    /// Return every chunk to the backing allocator
+    pub fn deinit(self: *Scratch) void {
+        freeChain(self.first);
+        self.* = .{};
+    }
+
+    fn bump(chunk: *Chunk, len: usize, alignment: usize) ?[*]u8 {
+        const base = @intFromPtr(chunk.bytes());
+        const start = std.mem.alignForward(usize, base + chunk.used, alignment) - base;
+        if (start + len > chunk.capacity) return null;
+        chunk.used = start + len;
+        return chunk.bytes() + start;
+    }
+
+    /// Append a chunk after `current`. Any chunks beyond it were too small
+    /// for this request and are released.
+    fn addChunk(self: *Scratch, min_size: usize) ?*Chunk {
+        const prev = if (self.current) |c| c.capacity else 0;
+        const size = @max(min_chunk, min_size, prev *| 2);
+        const raw = scratch_backing.alignedAlloc(u8, @alignOf(Chunk), @sizeOf(Chunk) + size) catch return null;
+        const chunk: *Chunk = @ptrCast(raw.ptr);
+        chunk.* = .{ .next = null, .capacity = size, .used = 0 };
+
+        if (self.current) |c| {
+            freeChain(c.next);
+            c.next = chunk;
+        } else {
+            freeChain(self.first);
+            self.first = chunk;
+        }
+        self.current = chunk;
+        return chunk;
+    }
+
+    fn freeChain(start: ?*Chunk) void {
+        var it = start;
+        while (it) |chunk| {
+            it = chunk.next;
+            scratch_backing.free(chunk.block());
+        }
+    }
+
+    fn isLast(self: *Scratch, buf: []u8) bool {
+        const chunk = self.current orelse return false;
+        return buf.ptr + buf.len == chunk.bytes() + chunk.used;
+    }
+
+    fn alloc_(ctx: *anyopaque, len: usize, ptr_align: u8, _: usize) ?[*]u8 {
+        const self: *Scratch = @ptrCast(@alignCast(ctx));
+        return self.allocBytes(len, @as(usize, 1) << @intCast(ptr_align));
+    }
+
+    fn resize_(ctx: *anyopaque, buf: []u8, _: u8, new_len: usize, _: usize) bool {
+        const self: *Scratch = @ptrCast(@alignCast(ctx));
+        if (!self.isLast(buf)) return new_len <= buf.len;
+        const chunk = self.current.?;
+        const start = chunk.used - buf.len;
+        if (start + new_len > chunk.capacity) return false;
+        chunk.used = start + new_len;
+        return true;
+    }
+
+    fn free_(ctx: *anyopaque, buf: []u8, _: u8, _: usize) void {
+        const self: *Scratch = @ptrCast(@alignCast(ctx));
+        if (self.isLast(buf)) self.current.?.used -= buf.len;
+    }
+};
+
 // ============================================================================
 // Tests
 // ============================================================================
@@ -125,6 +824,55 @@ test "basic allocation" {
     try std.testing.expect(slice.len == 100);
 }
 
+test "raw allocation tracks size and recycles small blocks" {
+    const p1 = allocRaw(100) orelse return error.OutOfMemory;
+    try std.testing.expectEqual(@as(usize, 100), rawSize(p1));
+    try std.testing.expect(std.mem.isAligned(@intFromPtr(p1), raw_min_align));
+    const gen1 = rawGeneration(p1);
+    freeRaw(p1);
+
+    // Same size class comes back from the thread cache with a new generation
+    const p2 = allocRaw(90) orelse return error.OutOfMemory;
+    try std.testing.expectEqual(p1, p2);
+    try std.testing.expect(rawGeneration(p2) != gen1);
+    freeRaw(p2);
+
+    const big = allocRawAligned(64 * 1024, 4096) orelse return error.OutOfMemory;
+    try std.testing.expect(std.mem.isAligned(@intFromPtr(big), 4096));
+    try std.testing.expectEqual(@as(usize, 64 * 1024), rawSize(big));
+    freeRaw(big);
+
+    freeRaw(null);
+    flushThreadCache();
+}
+
+test "growable byte buffers" {
+    var cap: usize = 0;
+    var buf: ?[*]u8 = null;
+    var len: usize = 0;
+
+    // Append 1 MiB in 4 KiB pieces, crossing the large-block threshold
+    const piece = [_]u8{0xAB} ** 4096;
+    while (len < 1024 * 1024) : (len += piece.len) {
+        if (len + piece.len > cap) {
+            const new_cap = growCapacity(cap, len + piece.len);
+            buf = if (buf) |p| reallocBytes(p, cap, new_cap) else allocBytes(new_cap);
+            try std.testing.expect(buf != null);
+            cap = new_cap;
+        }
+        @memcpy(buf.?[len..][0..piece.len], &piece);
+    }
+
+    try std.testing.expect(cap >= len);
+    try std.testing.expectEqual(@as(u8, 0xAB), buf.?[0]);
+    try std.testing.expectEqual(@as(u8, 0xAB), buf.?[len - 1]);
+
+    // Shrink back below the threshold (copies once), then free
+    buf = reallocBytes(buf.?, cap, 100);
+    try std.testing.expectEqual(@as(u8, 0xAB), buf.?[99]);
+    freeBytes(buf.?, 100);
+}
+
 test "pool allocation" {
     var pool = Pool.init();
     defer pool.deinit();
@@ -136,6 +884,47 @@ test "pool allocation" {
     try std.testing.expect(ptr.* == 42);
 }
 
+test "pool reuses slots and resets in bulk" {
+    var pool = Pool.init();
+    defer pool.deinit();
+
+    const a = try pool.create(idris_rts.IdrisValue);
+    pool.destroy(a);
+    const b = try pool.create(idris_rts.IdrisValue);
+    try std.testing.expectEqual(a, b);
+
+    // Same size class, different type, shares the free list
+    pool.destroy(b);
+    const c = try pool.create(u64);
+    try std.testing.expectEqual(@intFromPtr(a), @intFromPtr(c));
+
+    pool.reset();
+    const d = try pool.create(u64);
+    try std.testing.expectEqual(@intFromPtr(a), @intFromPtr(d));
+}
+
+test "typed pool" {
+    var pool = TypedPool(idris_rts.IdrisConstructor).init();
+    defer pool.deinit();
+
+    var ptrs: [100]*idris_rts.IdrisConstructor = undefined;
+    for (&ptrs, 0..) |*p, i| {
+        p.* = try pool.create();
+        p.*.* = .{ .tag = @intCast(i), .arity = 0, .args = undefined };
+    }
+    try std.testing.expectEqual(@as(usize, 100), pool.liveCount());
+    for (ptrs, 0..) |p, i| try std.testing.expectEqual(@as(u32, @intCast(i)), p.tag);
+
+    pool.reset();
+    try std.testing.expectEqual(@as(usize, 0), pool.liveCount());
+
+    const tl = threadPool(u64);
+    const x = try tl.create();
+    tl.destroy(x);
+    try std.testing.expectEqual(tl, threadPool(u64));
+    releaseThreadPool(u64);
+}
+
 test "arena allocation" {
     var arena = Arena.init();
     defer arena.deinit();
@@ -148,3 +937,29 @@ test "arena allocation" {
 
     // All freed at once when arena is deinitialized
 }
+
+test "scratch rewinds to marks and keeps its chunks" {
+    var scratch = Scratch{};
+    defer scratch.deinit();
+
+    const outer = scratch.mark();
+    const a = try scratch.dupe("outer");
+
+    const inner = scratch.mark();
+    _ = try scratch.alloc(u64, 10_000); // spills into a second chunk
+    const reserved = scratch.capacity();
+    scratch.restore(inner);
+
+    // The rewound space is handed out again
+    const b = try scratch.alloc(u8, 16);
+    try std.testing.expectEqual(@intFromPtr(a.ptr) + a.len, @intFromPtr(b.ptr));
+    try std.testing.expectEqualStrings("outer", a);
+
+    scratch.restore(outer);
+    _ = try scratch.alloc(u64, 10_000);
+    try std.testing.expectEqual(reserved, scratch.capacity());
+
+    var list = std.ArrayList(u8).init(scratch.allocator());
+    try list.appendSlice("grown in place");
+    try std.testing.expectEqualStrings("grown in place", list.items);
+}
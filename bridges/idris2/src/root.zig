@@ -16,8 +16,9 @@
 //! }
 //!
 //! // Register Zig callback for Idris to call
-//! pub fn registerCallback() void {
-//!     ffi.callbacks.register("myCallback", myZigFunction);
+//! pub fn registerCallback() !u32 {
+//!     // Keep the id and use callbacks.invokeById in hot paths
+//!     return ffi.callbacks.register("myCallback", myZigFunction);
 //! }
 //! ```
 //!
@@ -35,6 +36,8 @@ pub const memory = @import("memory.zig");
 pub const types = @import("types.zig");
 pub const idris_rts = @import("idris_rts.zig");
 pub const errors = @import("errors.zig");
+pub const kernels = @import("kernels.zig");
+pub const bulk = @import("bulk.zig");
 
 // ABI-specific modules
 pub const abi = struct {
@@ -55,6 +58,8 @@ pub const alloc = memory.alloc;
 pub const free = memory.free;
 pub const toIdrisString = types.toIdrisString;
 pub const fromIdrisString = types.fromIdrisString;
+pub const borrowIdrisString = types.borrowIdrisString;
+pub const arenaIdrisString = types.arenaIdrisString;
 pub const freeIdrisString = memory.freeIdrisString;
 pub const toOption = types.toOption;
 pub const fromOption = types.fromOption;
@@ -62,9 +67,18 @@ pub const toEither = types.toEither;
 pub const fromEither = types.fromEither;
 pub const toSlice = types.toSlice;
 pub const fromSlice = types.fromSlice;
+pub const toArray = types.toArray;
+pub const toArrayOwned = types.toArrayOwned;
+pub const fromArray = types.fromArray;
+pub const freeArray = types.freeArray;
+pub const gcRoot = idris_rts.gcRoot;
+pub const gcRootObject = idris_rts.gcRootObject;
+pub const gcUnroot = idris_rts.gcUnroot;
+pub const gcCollect = idris_rts.gcCollect;
+pub const gcSetRefcHooks = idris_rts.gcSetRefcHooks;
 
 /// ABI version for compatibility checking
-pub const ABI_VERSION: u32 = 1;
+pub const ABI_VERSION: u32 = 2;
 
 /// Initialize the Idris 2 runtime
 /// Must be called before any Idris functions
@@ -78,26 +92,211 @@ pub fn deinit() void {
     idris_rts.deinitRuntime();
 }
 
-/// Call an Idris function with automatic type marshalling
-pub fn call(comptime func: anytype, args: anytype) @TypeOf(callResult(func)) {
-    const ArgsType = @TypeOf(args);
-    const args_info = @typeInfo(ArgsType);
+/// Call an Idris function with automatic type marshalling.
+///
+/// Functions with a typed signature (ints, floats, bools, enums, slices,
+/// pointers) are called through a comptime trampoline: arguments are
+/// coerced to the parameter types and passed directly, with no IdrisValue
+/// boxing and no string copies. Only functions that take or return
+/// IdrisValue go through the dynamic union path (see callDynamic/callAs).
+pub fn call(comptime func: anytype, args: anytype) callResult(func) {
+    if (comptime isDirectSignature(@TypeOf(func))) {
+        return Trampoline(func).invoke(args);
+    }
+    return callDynamic(func, args);
+}
+
+/// Call an Idris function through the IdrisValue union and convert the
+/// result to T. For dynamic functions whose result type is only known to
+/// the caller.
+///
+/// A string result is copied into the thread scratch; if Idris returned it
+/// on the heap, that copy is freed, so the caller never frees anything.
+/// The scratch copy stays valid until the earliest of:
+/// - the next outermost call on this thread;
+/// - the return of the dynamic call this one is nested in, if any (e.g.
+///   callAs from a callback that Idris invoked during callDynamic);
+/// - the end of the enclosing Scope.
+/// Use callAsOwned to keep it longer.
+pub fn callAs(comptime T: type, comptime func: anytype, args: anytype) T {
+    const frame = CallFrame.enter();
+    const raw = frame.invoke(func, args);
+    if (comptime !types.isStringSlice(T)) {
+        defer frame.leave();
+        return types.fromIdris(T, &raw);
+    }
+    // The result may point at a marshalled argument: copy it before
+    // anything is rewound and keep the frame's scratch data
+    defer frame.leaveKeep();
+    defer memory.freeIdrisString(raw.string);
+    return types.fromIdrisScoped(T, &frame.handle.scratch, &raw);
+}
+
+/// callAs for results that must outlive the call. A string result is
+/// owned by the caller, who frees it with memory.allocator.free: a heap
+/// string from Idris is handed over as it is, anything else is copied to
+/// the heap.
+pub fn callAsOwned(comptime T: type, comptime func: anytype, args: anytype) T {
+    const frame = CallFrame.enter();
+    defer frame.leave();
+    const raw = frame.invoke(func, args);
+    if (comptime types.isStringSlice(T)) {
+        if (raw.string.ownedBytes()) |bytes| return bytes;
+        return memory.allocator.dupe(u8, raw.string.slice()) catch "";
+    }
+    return types.fromIdris(T, &raw);
+}
+
+/// Dynamic call: every argument is marshalled through types.toIdrisScoped.
+/// Marshalled strings live in the thread scratch and are released when
+/// the call returns, so Idris must not keep an argument string past the
+/// call (pass a toIdrisString copy in an IdrisValue for that).
+///
+/// The raw result is returned after that release: a string in it that
+/// points at a marshalled argument (an echoed argument, say) is already
+/// dangling. Use callAs or callAsOwned for string results.
+pub fn callDynamic(comptime func: anytype, args: anytype) callResult(func) {
+    const frame = CallFrame.enter();
+    defer frame.leave();
+    return frame.invoke(func, args);
+}
+
+/// Scratch scope of one dynamic call
+const CallFrame = struct {
+    handle: *idris_rts.ThreadHandle,
+    saved: memory.Scratch.Mark,
+
+    fn enter() CallFrame {
+        const handle = idris_rts.currentThread();
+        // An outermost call outside any Scope: data kept by the previous
+        // call (callAs results) is no longer referenced
+        if (handle.call_depth == 0 and handle.scope_depth == 0) handle.scratch.reset();
+        handle.call_depth += 1;
+        return .{ .handle = handle, .saved = handle.scratch.mark() };
+    }
+
+    /// Rewind the scratch to where the call started
+    fn leave(self: CallFrame) void {
+        self.handle.scratch.restore(self.saved);
+        self.handle.call_depth -= 1;
+    }
+
+    /// Leave without rewinding; the data goes with the enclosing scope
+    fn leaveKeep(self: CallFrame) void {
+        self.handle.call_depth -= 1;
+    }
+
+    fn invoke(self: CallFrame, comptime func: anytype, args: anytype) callResult(func) {
+        const args_info = @typeInfo(@TypeOf(args));
 
-    if (args_info != .Struct) {
-        @compileError("Expected tuple of arguments");
+        if (args_info != .Struct) {
+            @compileError("Expected tuple of arguments");
+        }
+
+        // Marshal arguments to Idris types
+        var idris_args: std.meta.ArgsTuple(@TypeOf(func)) = undefined;
+        inline for (args_info.Struct.fields, 0..) |field, i| {
+            const value = @field(args, field.name);
+            idris_args[i] = if (@TypeOf(value) == idris_rts.IdrisValue)
+                value
+            else
+                types.toIdrisScoped(&self.handle.scratch, value);
+        }
+
+        return @call(.auto, func, idris_args);
+    }
+};
+
+/// Caller-opened scratch scope. Inside it, callAs results stay valid until
+/// `end` instead of until the next call, and `allocator` hands out scratch
+/// memory released at the same point.
+///
+///     const scope = ffi.Scope.begin();
+///     defer scope.end();
+pub const Scope = struct {
+    handle: *idris_rts.ThreadHandle,
+    saved: memory.Scratch.Mark,
+
+    pub fn begin() Scope {
+        const handle = idris_rts.currentThread();
+        handle.scope_depth += 1;
+        return .{ .handle = handle, .saved = handle.scratch.mark() };
+    }
+
+    pub fn end(self: Scope) void {
+        self.handle.scratch.restore(self.saved);
+        self.handle.scope_depth -= 1;
     }
 
-    // Marshal arguments to Idris types
-    var idris_args: [args_info.Struct.fields.len]idris_rts.IdrisValue = undefined;
-    inline for (args_info.Struct.fields, 0..) |field, i| {
-        idris_args[i] = types.toIdris(@field(args, field.name));
+    pub fn allocator(self: Scope) std.mem.Allocator {
+        return self.handle.scratch.allocator();
     }
+};
+
+/// Direct, typed call path for a known function signature
+pub fn Trampoline(comptime func: anytype) type {
+    const FnType = @TypeOf(func);
+    const params = @typeInfo(FnType).Fn.params;
+
+    return struct {
+        pub const Args = std.meta.ArgsTuple(FnType);
+        pub const Return = callResult(func);
+
+        /// Coerce `args` to the parameter types and call `func` directly.
+        /// `func` may be an extern symbol with no body, so the call itself
+        /// is left to the optimiser; this wrapper is inlined regardless.
+        pub inline fn invoke(args: anytype) Return {
+            const fields = @typeInfo(@TypeOf(args)).Struct.fields;
+            if (fields.len != params.len) {
+                @compileError("Expected " ++ std.fmt.comptimePrint("{d}", .{params.len}) ++ " arguments");
+            }
+
+            var typed: Args = undefined;
+            inline for (fields, 0..) |field, i| {
+                typed[i] = coerceArg(params[i].type.?, @field(args, field.name));
+            }
+            return @call(.auto, func, typed);
+        }
+    };
+}
 
-    // Call the function
-    const result = @call(.auto, func, idris_args);
+/// Convert a Zig argument to a parameter type without boxing
+fn coerceArg(comptime P: type, arg: anytype) P {
+    const A = @TypeOf(arg);
+    if (A == P) return arg;
+
+    return switch (@typeInfo(P)) {
+        .Int => switch (@typeInfo(A)) {
+            .Int => @intCast(arg),
+            .Bool => @intFromBool(arg),
+            else => arg,
+        },
+        .Float => switch (@typeInfo(A)) {
+            .Float => @floatCast(arg),
+            .Int => @floatFromInt(arg),
+            else => arg,
+        },
+        else => arg,
+    };
+}
 
-    // Marshal result back to Zig type
-    return types.fromIdris(@TypeOf(callResult(func)), result);
+/// Types passed directly (in registers) by the typed call path
+fn isDirectType(comptime T: type) bool {
+    if (T == idris_rts.IdrisValue) return false;
+    return switch (@typeInfo(T)) {
+        .Int, .Float, .Bool, .Enum, .Void, .Pointer => true,
+        .Optional => |opt| @typeInfo(opt.child) == .Pointer,
+        else => false,
+    };
+}
+
+fn isDirectSignature(comptime FnType: type) bool {
+    const fn_info = @typeInfo(FnType).Fn;
+    inline for (fn_info.params) |param| {
+        const P = param.type orelse return false;
+        if (!isDirectType(P)) return false;
+    }
+    return isDirectType(fn_info.return_type orelse return false);
 }
 
 fn callResult(comptime func: anytype) type {
@@ -128,47 +327,178 @@ pub fn getErrorMessage(err: errors.IdrisError) []const u8 {
 pub const CallbackFn = *const fn (args: []const idris_rts.IdrisValue) idris_rts.IdrisValue;
 
 /// Callback registry for bidirectional FFI
+///
+/// Callbacks live in fixed-size segments that never move once allocated, so
+/// invokeById is two array indexes and a generation check with no locking.
+/// Names map to ids through a hash map behind a reader-writer lock; resolve
+/// a name once with idOf and invoke by id in hot loops. Registration and
+/// removal are serialised by a mutex and may run concurrently with readers.
 pub const callbacks = struct {
-    const max_callbacks = 256;
-    var registry: [max_callbacks]?CallbackEntry = [_]?CallbackEntry{null} ** max_callbacks;
-    var count: usize = 0;
-
-    const CallbackEntry = struct {
-        name: []const u8,
-        func: CallbackFn,
+    /// Returned by idOf/register exports when there is no such callback
+    pub const invalid_id: u32 = std.math.maxInt(u32);
+
+    const segment_bits = 8;
+    const segment_len = 1 << segment_bits;
+    const max_segments = 256;
+    const index_bits = 16;
+    const index_mask: u32 = (1 << index_bits) - 1;
+
+    /// One registered callback. `func` is 0 when the slot is free; the
+    /// generation is bumped on every removal so stale ids miss.
+    const Slot = struct {
+        func: std.atomic.Value(usize) = std.atomic.Value(usize).init(0),
+        generation: std.atomic.Value(u32) = std.atomic.Value(u32).init(0),
+        /// The slot's key in `names` (write_lock held to read or write)
+        name: []const u8 = "",
     };
 
-    /// Register a Zig callback that Idris code can invoke
-    pub fn register(name: []const u8, func: CallbackFn) !void {
-        if (count >= max_callbacks) return error.TooManyCallbacks;
-        registry[count] = .{ .name = name, .func = func };
-        count += 1;
+    const Segment = [segment_len]Slot;
+
+    var segments: [max_segments]std.atomic.Value(?*Segment) =
+        [_]std.atomic.Value(?*Segment){std.atomic.Value(?*Segment).init(null)} ** max_segments;
+    var names: std.StringHashMapUnmanaged(u32) = .{};
+    var names_lock: std.Thread.RwLock = .{};
+    var write_lock: std.Thread.Mutex = .{};
+    var free_slots: std.ArrayListUnmanaged(u32) = .{};
+    var next_slot: u32 = 0;
+    var count = std.atomic.Value(usize).init(0);
+
+    fn makeId(index: u32, generation: u32) u32 {
+        return (generation << index_bits) | index;
+    }
+
+    fn slotAt(index: u32) ?*Slot {
+        const segment = segments[index >> segment_bits].load(.acquire) orelse return null;
+        return &segment[index & (segment_len - 1)];
+    }
+
+    /// Reserve a slot index (write_lock held)
+    fn acquireSlot() !u32 {
+        if (free_slots.popOrNull()) |index| return index;
+
+        const index = next_slot;
+        if (index >= max_segments * segment_len) return error.TooManyCallbacks;
+
+        const seg = index >> segment_bits;
+        if (segments[seg].load(.monotonic) == null) {
+            const segment = try memory.allocator.create(Segment);
+            segment.* = [_]Slot{.{}} ** segment_len;
+            segments[seg].store(segment, .release);
+        }
+        next_slot += 1;
+        return index;
+    }
+
+    /// Empty a slot and invalidate ids pointing at it (write_lock held)
+    fn releaseSlot(index: u32) void {
+        const slot = slotAt(index) orelse return;
+        slot.func.store(0, .release);
+        slot.name = "";
+        // Generations are 16 bits so ids fit a u32; 0xFFFF is skipped so
+        // no live id ever equals invalid_id
+        const next_gen = (slot.generation.load(.monotonic) + 1) % index_mask;
+        slot.generation.store(next_gen, .release);
+        free_slots.append(memory.allocator, index) catch {
+            // Slot is leaked rather than reused; ids to it still miss
+        };
+        _ = count.fetchSub(1, .monotonic);
+    }
+
+    /// Register a Zig callback that Idris code can invoke.
+    /// Returns an id for invokeById. Re-registering a name replaces its
+    /// function and keeps the id.
+    pub fn register(name: []const u8, func: CallbackFn) !u32 {
+        write_lock.lock();
+        defer write_lock.unlock();
+
+        if (idOfLocked(name)) |id| {
+            slotAt(id & index_mask).?.func.store(@intFromPtr(func), .release);
+            return id;
+        }
+
+        const index = try acquireSlot();
+        errdefer free_slots.append(memory.allocator, index) catch {};
+
+        const key = try memory.allocator.dupe(u8, name);
+        errdefer memory.allocator.free(key);
+
+        const slot = slotAt(index).?;
+        const id = makeId(index, slot.generation.load(.monotonic));
+        {
+            names_lock.lock();
+            defer names_lock.unlock();
+            try names.put(memory.allocator, key, id);
+        }
+        slot.name = key;
+        slot.func.store(@intFromPtr(func), .release);
+        _ = count.fetchAdd(1, .monotonic);
+        return id;
     }
 
     /// Unregister a callback by name
     pub fn unregister(name: []const u8) void {
-        for (&registry, 0..) |*entry, i| {
-            if (entry.*) |e| {
-                if (std.mem.eql(u8, e.name, name)) {
-                    entry.* = null;
-                    // Compact if last
-                    if (i == count - 1) count -= 1;
-                    return;
-                }
-            }
+        write_lock.lock();
+        defer write_lock.unlock();
+
+        const entry = blk: {
+            names_lock.lock();
+            defer names_lock.unlock();
+            break :blk names.fetchRemove(name);
+        } orelse return;
+
+        releaseSlot(entry.value & index_mask);
+        memory.allocator.free(entry.key);
+    }
+
+    /// Unregister a callback by id (no-op for stale ids)
+    pub fn unregisterId(id: u32) void {
+        write_lock.lock();
+        defer write_lock.unlock();
+
+        // The id names its slot; the slot names its map entry
+        const index = id & index_mask;
+        const slot = slotAt(index) orelse return;
+        if (slot.func.load(.monotonic) == 0) return;
+        if (slot.generation.load(.monotonic) != id >> index_bits) return;
+
+        const key = slot.name;
+        {
+            names_lock.lock();
+            defer names_lock.unlock();
+            _ = names.remove(key);
         }
+        releaseSlot(index);
+        memory.allocator.free(key);
+    }
+
+    fn idOfLocked(name: []const u8) ?u32 {
+        names_lock.lockShared();
+        defer names_lock.unlockShared();
+        return names.get(name);
+    }
+
+    /// Resolve a name to its id (one hash lookup)
+    pub fn idOf(name: []const u8) ?u32 {
+        return idOfLocked(name);
+    }
+
+    /// Lookup a callback by id; null for unknown or stale ids
+    pub fn lookupId(id: u32) ?CallbackFn {
+        const slot = slotAt(id & index_mask) orelse return null;
+
+        // Load the function before checking the generation: removal clears
+        // func before bumping the generation, so a matching generation
+        // means the function belongs to this id.
+        const func = slot.func.load(.acquire);
+        if (func == 0) return null;
+        if (slot.generation.load(.acquire) != id >> index_bits) return null;
+        return @ptrFromInt(func);
     }
 
     /// Lookup a callback by name
     pub fn lookup(name: []const u8) ?CallbackFn {
-        for (registry[0..count]) |entry| {
-            if (entry) |e| {
-                if (std.mem.eql(u8, e.name, name)) {
-                    return e.func;
-                }
-            }
-        }
-        return null;
+        const id = idOf(name) orelse return null;
+        return lookupId(id);
     }
 
     /// Invoke a registered callback by name
@@ -179,17 +509,50 @@ pub const callbacks = struct {
         return null;
     }
 
-    /// Clear all registered callbacks
+    /// Invoke a registered callback by id (no hashing, no locking)
+    pub fn invokeById(id: u32, args: []const idris_rts.IdrisValue) ?idris_rts.IdrisValue {
+        if (lookupId(id)) |func| {
+            return func(args);
+        }
+        return null;
+    }
+
+    /// Clear all registered callbacks. Outstanding ids become stale.
     pub fn clear() void {
-        for (&registry) |*entry| {
-            entry.* = null;
+        write_lock.lock();
+        defer write_lock.unlock();
+
+        names_lock.lock();
+        var it = names.iterator();
+        while (it.next()) |entry| {
+            releaseSlot(entry.value_ptr.* & index_mask);
+            memory.allocator.free(entry.key_ptr.*);
+        }
+        names.clearRetainingCapacity();
+        names_lock.unlock();
+    }
+
+    /// Clear callbacks and release the registry's memory.
+    /// No other thread may use the registry during or after this call.
+    pub fn deinit() void {
+        clear();
+
+        write_lock.lock();
+        defer write_lock.unlock();
+
+        for (&segments) |*seg| {
+            if (seg.swap(null, .acq_rel)) |segment| memory.allocator.destroy(segment);
         }
-        count = 0;
+        names.deinit(memory.allocator);
+        names = .{};
+        free_slots.deinit(memory.allocator);
+        free_slots = .{};
+        next_slot = 0;
     }
 
     /// Get count of registered callbacks
     pub fn getCount() usize {
-        return count;
+        return count.load(.monotonic);
     }
 };
 
@@ -225,6 +588,21 @@ pub export fn idris2_zig_invoke_callback(
     return callbacks.invoke(name, args) orelse .{ .int = 0 };
 }
 
+/// Resolve a callback name to an id for idris2_zig_invoke_callback_id.
+/// Returns callbacks.invalid_id if the name is not registered.
+pub export fn idris2_zig_callback_id(name_ptr: [*]const u8, name_len: usize) u32 {
+    return callbacks.idOf(name_ptr[0..name_len]) orelse callbacks.invalid_id;
+}
+
+/// Invoke a registered Zig callback by id (fast path for hot loops)
+pub export fn idris2_zig_invoke_callback_id(
+    id: u32,
+    args_ptr: [*]const idris_rts.IdrisValue,
+    args_len: usize,
+) idris_rts.IdrisValue {
+    return callbacks.invokeById(id, args_ptr[0..args_len]) orelse .{ .int = 0 };
+}
+
 // ============================================================================
 // Tests
 // ============================================================================
@@ -238,6 +616,125 @@ test "init and deinit" {
     deinit();
 }
 
+test "typed calls use the direct trampoline" {
+    const funcs = struct {
+        fn add(a: i64, b: i64) i64 {
+            return a + b;
+        }
+        fn scale(x: f64, by: f64) f64 {
+            return x * by;
+        }
+        fn len(s: []const u8) usize {
+            return s.len;
+        }
+    };
+
+    comptime std.debug.assert(isDirectSignature(@TypeOf(funcs.add)));
+    try std.testing.expectEqual(@as(i64, 42), call(funcs.add, .{ 40, @as(i32, 2) }));
+    try std.testing.expectEqual(@as(f64, 5.0), call(funcs.scale, .{ 2.5, 2 }));
+    try std.testing.expectEqual(@as(usize, 5), call(funcs.len, .{"hello"}));
+}
+
+test "heap string results are handed over or freed" {
+    const dyn = struct {
+        var made: ?[*]u8 = null;
+
+        fn make(v: idris_rts.IdrisValue) idris_rts.IdrisValue {
+            _ = v;
+            const str = types.toIdrisString("a heap string well past the inline capacity");
+            made = str.data;
+            return .{ .string = str };
+        }
+    };
+
+    // callAsOwned passes Idris's allocation straight to the caller
+    const owned = callAsOwned([]const u8, dyn.make, .{@as(i64, 0)});
+    try std.testing.expectEqual(@as([*]const u8, dyn.made.?), owned.ptr);
+    memory.allocator.free(owned);
+
+    // callAs copies into the scratch and frees the heap string itself
+    // (warm up first so scratch growth is not counted; with -Dalloc-stats
+    // off all counts are zero)
+    _ = callAs([]const u8, dyn.make, .{@as(i64, 0)});
+    const before = memory.allocStats();
+    const scoped = callAs([]const u8, dyn.make, .{@as(i64, 0)});
+    const after = memory.allocStats();
+    try std.testing.expectEqualStrings("a heap string well past the inline capacity", scoped);
+    try std.testing.expect(@intFromPtr(scoped.ptr) != @intFromPtr(dyn.made.?));
+    try std.testing.expectEqual(after.allocs - before.allocs, after.frees - before.frees);
+}
+
+test "typed calls reach extern functions" {
+    // Stands in for an Idris/RefC-compiled symbol: defined with the C ABI
+    // and called only through its body-less extern declaration
+    const exported = struct {
+        export fn idris2_test_trampoline_add(a: i64, b: i64) callconv(.C) i64 {
+            return a + b;
+        }
+    };
+    const linked = struct {
+        extern fn idris2_test_trampoline_add(a: i64, b: i64) callconv(.C) i64;
+    };
+    comptime std.debug.assert(@TypeOf(exported.idris2_test_trampoline_add) == @TypeOf(linked.idris2_test_trampoline_add));
+
+    comptime std.debug.assert(isDirectSignature(@TypeOf(linked.idris2_test_trampoline_add)));
+    try std.testing.expectEqual(@as(i64, 42), call(linked.idris2_test_trampoline_add, .{ 40, @as(i32, 2) }));
+}
+
+test "dynamic calls keep the IdrisValue path" {
+    const dyn = struct {
+        fn double(v: idris_rts.IdrisValue) idris_rts.IdrisValue {
+            return .{ .int = v.int * 2 };
+        }
+    }.double;
+
+    comptime std.debug.assert(!isDirectSignature(@TypeOf(dyn)));
+    try std.testing.expectEqual(@as(i64, 42), call(dyn, .{@as(i64, 21)}).int);
+    try std.testing.expectEqual(@as(i64, 42), callAs(i64, dyn, .{@as(i64, 21)}));
+}
+
+test "dynamic string arguments live in the call scope" {
+    const dyn = struct {
+        fn length(v: idris_rts.IdrisValue) idris_rts.IdrisValue {
+            return .{ .int = @intCast(v.string.length()) };
+        }
+        fn echo(v: idris_rts.IdrisValue) idris_rts.IdrisValue {
+            return v;
+        }
+    };
+    const long = "an argument well past the inline string capacity";
+    const handle = idris_rts.currentThread();
+
+    try std.testing.expectEqual(@as(i64, long.len), callAs(i64, dyn.length, .{long}));
+    const start = handle.scratch.mark();
+    const reserved = handle.scratch.capacity();
+    for (0..100) |_| {
+        try std.testing.expectEqual(@as(i64, long.len), callAs(i64, dyn.length, .{@as([]const u8, long)}));
+    }
+    // Arguments are released on return: same position, no new chunks
+    try std.testing.expectEqual(start, handle.scratch.mark());
+    try std.testing.expectEqual(reserved, handle.scratch.capacity());
+    try std.testing.expectEqual(@as(u32, 0), handle.call_depth);
+
+    // A result that echoes an argument outlives the call
+    const echoed = callAs([]const u8, dyn.echo, .{long});
+    try std.testing.expectEqualStrings(long, echoed);
+
+    const owned = callAsOwned([]const u8, dyn.echo, .{long});
+    defer memory.allocator.free(owned);
+    _ = callAs(i64, dyn.length, .{"overwrites the previous call's scratch"});
+    try std.testing.expectEqualStrings(long, owned);
+
+    // Inside a Scope results accumulate until the scope ends
+    const scope = Scope.begin();
+    const a = callAs([]const u8, dyn.echo, .{"first result, not inline"});
+    const b = callAs([]const u8, dyn.echo, .{"second result, not inline"});
+    try std.testing.expectEqualStrings("first result, not inline", a);
+    try std.testing.expectEqualStrings("second result, not inline", b);
+    scope.end();
+    try std.testing.expectEqual(@as(u32, 0), handle.scope_depth);
+}
+
 test "callback registration" {
     const testCallback = struct {
         fn call(args: []const idris_rts.IdrisValue) idris_rts.IdrisValue {
@@ -248,14 +745,59 @@ test "callback registration" {
         }
     }.call;
 
-    try callbacks.register("double", testCallback);
+    defer callbacks.deinit();
+
+    const id = try callbacks.register("double", testCallback);
     try std.testing.expect(callbacks.getCount() == 1);
+    try std.testing.expectEqual(id, callbacks.idOf("double").?);
 
     const args = [_]idris_rts.IdrisValue{.{ .int = 21 }};
     const result = callbacks.invoke("double", &args);
     try std.testing.expect(result != null);
     try std.testing.expect(result.?.int == 42);
+    try std.testing.expect(callbacks.invokeById(id, &args).?.int == 42);
 
     callbacks.unregister("double");
+    try std.testing.expect(callbacks.getCount() == 0);
+    try std.testing.expect(callbacks.invokeById(id, &args) == null);
+
+    // The freed slot is reused under a new generation; the old id stays stale
+    const new_id = try callbacks.register("double_again", testCallback);
+    try std.testing.expect(new_id != id);
+    try std.testing.expect(callbacks.invokeById(id, &args) == null);
+    try std.testing.expect(callbacks.invokeById(new_id, &args).?.int == 42);
+
+    // Removal by id resolves the slot directly; stale ids are ignored
+    callbacks.unregisterId(id);
+    try std.testing.expect(callbacks.getCount() == 1);
+    callbacks.unregisterId(new_id);
+    try std.testing.expect(callbacks.getCount() == 0);
+    try std.testing.expect(callbacks.idOf("double_again") == null);
+    try std.testing.expect(callbacks.invokeById(new_id, &args) == null);
+
+    _ = try callbacks.register("double_again", testCallback);
     callbacks.clear();
+    try std.testing.expect(callbacks.lookup("double_again") == null);
+}
+
+test "callback registry grows past one segment" {
+    const identity = struct {
+        fn call(args: []const idris_rts.IdrisValue) idris_rts.IdrisValue {
+            return args[0];
+        }
+    }.call;
+
+    defer callbacks.deinit();
+
+    var name_buf: [16]u8 = undefined;
+    var last_id: u32 = 0;
+    for (0..600) |i| {
+        const name = try std.fmt.bufPrint(&name_buf, "cb{d}", .{i});
+        last_id = try callbacks.register(name, identity);
+    }
+    try std.testing.expectEqual(@as(usize, 600), callbacks.getCount());
+
+    const args = [_]idris_rts.IdrisValue{.{ .int = 7 }};
+    try std.testing.expect(callbacks.invokeById(last_id, &args).?.int == 7);
+    try std.testing.expect(callbacks.invoke("cb599", &args).?.int == 7);
 }
@@ -12,23 +12,59 @@ const idris_rts = @import("idris_rts.zig");
 // String Conversions
 // ============================================================================
 
-/// Convert a Zig string slice to an Idris string
+/// Convert a Zig string slice to an Idris string.
+/// Strings up to IdrisString.inline_capacity bytes are stored inline with no
+/// allocation; longer ones are copied to the heap. Free with freeIdrisString.
 pub fn toIdrisString(str: []const u8) idris_rts.IdrisString {
-    const data = memory.allocator.alloc(u8, str.len) catch return .{ .data = null, .len = 0 };
-    @memcpy(data, str);
+    if (str.len <= idris_rts.IdrisString.inline_capacity) {
+        return idris_rts.IdrisString.initInline(str);
+    }
+
+    const data = memory.allocator.dupe(u8, str) catch return idris_rts.IdrisString.empty();
     return .{
         .data = data.ptr,
-        .len = str.len,
+        .len = data.len,
     };
 }
 
-/// Convert an Idris string to a Zig string slice
-/// The returned slice is valid until the Idris string is freed
-pub fn fromIdrisString(str: idris_rts.IdrisString) []const u8 {
-    if (str.data) |data| {
-        return data[0..str.len];
+/// Borrow a Zig string as an Idris string without copying.
+/// The caller keeps `str` alive for as long as the Idris string is used;
+/// freeIdrisString is a no-op on the result.
+pub fn borrowIdrisString(str: []const u8) idris_rts.IdrisString {
+    return idris_rts.IdrisString.borrowed(str);
+}
+
+/// Convert a Zig string to an Idris string whose lifetime is tied to `arena`.
+/// Short strings are stored inline; longer ones are copied into the arena
+/// and released together when the arena is reset or deinitialised.
+pub fn arenaIdrisString(arena: *memory.Arena, str: []const u8) !idris_rts.IdrisString {
+    if (str.len <= idris_rts.IdrisString.inline_capacity) {
+        return idris_rts.IdrisString.initInline(str);
+    }
+
+    const data = try arena.alloc(u8, str.len);
+    @memcpy(data, str);
+    return idris_rts.IdrisString.borrowed(data);
+}
+
+/// Convert a Zig string to an Idris string in a scratch scope (see
+/// root.call). Short strings are stored inline; longer ones are copied
+/// with a pointer bump and released when the scratch is rewound. If the
+/// scratch cannot grow, `str` is borrowed instead.
+pub fn scratchIdrisString(scratch: *memory.Scratch, str: []const u8) idris_rts.IdrisString {
+    if (str.len <= idris_rts.IdrisString.inline_capacity) {
+        return idris_rts.IdrisString.initInline(str);
     }
-    return "";
+
+    const data = scratch.dupe(str) catch return idris_rts.IdrisString.borrowed(str);
+    return idris_rts.IdrisString.borrowed(data);
+}
+
+/// Convert an Idris string to a Zig string slice (no copy).
+/// The returned slice is valid until the Idris string is freed, and for
+/// inline strings only while `str` itself is alive.
+pub fn fromIdrisString(str: *const idris_rts.IdrisString) []const u8 {
+    return str.slice();
 }
 
 // ============================================================================
@@ -122,6 +158,44 @@ pub fn fromSlice(comptime T: type, list: idris_rts.IdrisList(T)) ![]T {
     return result;
 }
 
+// ============================================================================
+// Array Conversions (contiguous, for bulk numeric data)
+// ============================================================================
+
+/// Borrow a Zig slice as an Idris array without copying.
+/// The array is valid only as long as `slice` is.
+pub fn toArray(comptime T: type, slice: []const T) idris_rts.IdrisArray(T) {
+    return .{
+        .data = if (slice.len > 0) @constCast(slice.ptr) else null,
+        .len = slice.len,
+        .owned = 0,
+    };
+}
+
+/// Copy a Zig slice into a bridge-owned Idris array (one allocation).
+/// Release with freeArray.
+pub fn toArrayOwned(comptime T: type, slice: []const T) !idris_rts.IdrisArray(T) {
+    if (slice.len == 0) return toArray(T, slice);
+
+    const data = try memory.allocator.dupe(T, slice);
+    return .{ .data = data.ptr, .len = data.len, .owned = 1 };
+}
+
+/// View an Idris array as a Zig slice without copying
+pub fn fromArray(comptime T: type, array: idris_rts.IdrisArray(T)) []const T {
+    if (array.data) |data| {
+        return data[0..array.len];
+    }
+    return &[_]T{};
+}
+
+/// Free an array created by toArrayOwned (no-op for borrowed arrays)
+pub fn freeArray(comptime T: type, array: idris_rts.IdrisArray(T)) void {
+    if (array.owned != 0) {
+        if (array.data) |data| memory.allocator.free(data[0..array.len]);
+    }
+}
+
 // ============================================================================
 // Pair/Tuple Conversions
 // ============================================================================
@@ -164,21 +238,59 @@ pub fn toIdris(value: anytype) idris_rts.IdrisValue {
     };
 }
 
-/// Convert an Idris value to the specified Zig type
-pub fn fromIdris(comptime T: type, value: idris_rts.IdrisValue) T {
+/// toIdris for call arguments: strings (slices and string literals) go
+/// into `scratch` instead of the heap, everything else as toIdris
+pub fn toIdrisScoped(scratch: *memory.Scratch, value: anytype) idris_rts.IdrisValue {
+    const T = @TypeOf(value);
+
+    if (@typeInfo(T) == .Pointer) {
+        const ptr = @typeInfo(T).Pointer;
+        if (ptr.size == .Slice and ptr.child == u8) {
+            return .{ .string = scratchIdrisString(scratch, value) };
+        }
+        if (ptr.size == .One and @typeInfo(ptr.child) == .Array and @typeInfo(ptr.child).Array.child == u8) {
+            return .{ .string = scratchIdrisString(scratch, value) };
+        }
+    }
+    return toIdris(value);
+}
+
+/// fromIdris for call results: strings of every representation are copied
+/// into `scratch`, so the result never depends on `value`. The caller
+/// still frees a heap string in `value` (root.callAs does).
+pub fn fromIdrisScoped(comptime T: type, scratch: *memory.Scratch, value: *const idris_rts.IdrisValue) T {
+    if (comptime isStringSlice(T)) {
+        return scratch.dupe(value.string.slice()) catch "";
+    }
+    return fromIdris(T, value);
+}
+
+/// True for the slice types fromIdris produces from an Idris string
+pub fn isStringSlice(comptime T: type) bool {
+    return switch (@typeInfo(T)) {
+        .Pointer => |ptr| ptr.size == .Slice and ptr.child == u8,
+        else => false,
+    };
+}
+
+/// Convert an Idris value to the specified Zig type.
+/// Strings are never copied: the slice borrows from `value` (inline
+/// strings) or from the bytes it points at, so it is valid while both are.
+/// Use fromIdrisScoped or memory.allocator.dupe for a copy.
+pub fn fromIdris(comptime T: type, value: *const idris_rts.IdrisValue) T {
     return switch (@typeInfo(T)) {
         .Int => @intCast(value.int),
         .Float => @floatCast(value.float),
         .Bool => value.int != 0,
         .Pointer => |ptr| {
             if (ptr.size == .Slice and ptr.child == u8) {
-                return fromIdrisString(value.string);
+                return fromIdrisString(&value.string);
             }
             return @ptrCast(@alignCast(value.ptr));
         },
         .Optional => |opt| {
             return switch (value.maybe.tag) {
-                .just => fromIdris(opt.child, value.maybe.value),
+                .just => fromIdris(opt.child, &value.maybe.value),
                 .nothing => null,
             };
         },
@@ -195,8 +307,62 @@ test "string conversion roundtrip" {
     const idris_str = toIdrisString(original);
     defer memory.freeIdrisString(idris_str);
 
-    const back = fromIdrisString(idris_str);
+    const back = fromIdrisString(&idris_str);
     try std.testing.expectEqualStrings(original, back);
+
+    const long = "a string longer than the inline capacity";
+    const heap_str = toIdrisString(long);
+    defer memory.freeIdrisString(heap_str);
+    try std.testing.expect(heap_str.isOwned());
+    try std.testing.expectEqualStrings(long, fromIdrisString(&heap_str));
+}
+
+test "fromIdris borrows strings of every representation" {
+    const long = "a string longer than the inline capacity";
+    const inline_value = idris_rts.IdrisValue{ .string = idris_rts.IdrisString.initInline("short") };
+    const short = fromIdris([]const u8, &inline_value);
+    try std.testing.expectEqualStrings("short", short);
+    try std.testing.expectEqual(@as([*]const u8, @ptrCast(&inline_value)), short.ptr);
+
+    const borrowed_value = idris_rts.IdrisValue{ .string = borrowIdrisString(long) };
+    try std.testing.expectEqual(@as([*]const u8, long), fromIdris([]const u8, &borrowed_value).ptr);
+}
+
+test "borrowed and arena strings are not copied to the heap" {
+    const long = "a string longer than the inline capacity";
+
+    const borrowed = borrowIdrisString(long);
+    defer memory.freeIdrisString(borrowed);
+    try std.testing.expectEqual(@as([*]const u8, long), fromIdrisString(&borrowed).ptr);
+
+    var arena = memory.Arena.init();
+    defer arena.deinit();
+    const scoped = try arenaIdrisString(&arena, long);
+    defer memory.freeIdrisString(scoped);
+    try std.testing.expect(!scoped.isOwned());
+    try std.testing.expectEqualStrings(long, fromIdrisString(&scoped));
+}
+
+test "scoped conversions bump the scratch instead of the heap" {
+    var scratch = memory.Scratch{};
+    defer scratch.deinit();
+    const long = "a string longer than the inline capacity";
+
+    const start = scratch.mark();
+    const arg = toIdrisScoped(&scratch, long);
+    try std.testing.expect(arg.string.isBorrowed());
+    try std.testing.expect(@intFromPtr(arg.string.slice().ptr) != @intFromPtr(long.ptr));
+    try std.testing.expectEqualStrings(long, arg.string.slice());
+    try std.testing.expect(toIdrisScoped(&scratch, "short").string.isInline());
+
+    const inline_value = idris_rts.IdrisValue{ .string = idris_rts.IdrisString.initInline("short") };
+    const short = fromIdrisScoped([]const u8, &scratch, &inline_value);
+    try std.testing.expectEqualStrings("short", short);
+
+    // Rewinding hands the same bytes to the next call
+    scratch.restore(start);
+    const again = toIdrisScoped(&scratch, long);
+    try std.testing.expectEqual(arg.string.slice().ptr, again.string.slice().ptr);
 }
 
 test "option conversion" {
@@ -210,6 +376,20 @@ test "option conversion" {
     try std.testing.expect(fromOption(i32, idris_none) == null);
 }
 
+test "array conversion is zero-copy" {
+    const values = [_]f64{ 1.5, 2.5, 3.5 };
+
+    const borrowed = toArray(f64, &values);
+    defer freeArray(f64, borrowed);
+    try std.testing.expectEqual(@as(usize, 3), borrowed.len);
+    try std.testing.expectEqual(@as([*]const f64, &values), fromArray(f64, borrowed).ptr);
+
+    const owned = try toArrayOwned(f64, &values);
+    defer freeArray(f64, owned);
+    try std.testing.expect(owned.owned != 0);
+    try std.testing.expectEqualSlices(f64, &values, fromArray(f64, owned));
+}
+
 test "either conversion" {
     const left: Either([]const u8, i32) = .{ .left = "error" };
     const right: Either([]const u8, i32) = .{ .right = 42 };
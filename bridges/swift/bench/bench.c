@@ -0,0 +1,236 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+// bench.c - FFI boundary cost benchmarks for the Swift-Zig bridge
+//
+// Calls the library exactly as Swift does (through SwiftZigFFI.h) and
+// reports ns/call for each export, callback round-trips, and by-value vs
+// pointer-out struct passing.
+//
+// Run:    zig build bench                 # JSON to stdout
+//         zig build bench -- results.json # JSON to file
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "SwiftZigFFI.h"
+
+// Bench-only probes (bench/probes.zig)
+void szf_bench_noop(void);
+SzfResult szf_bench_result_value(int32_t code);
+void szf_bench_result_out(int32_t code, SzfResult* out);
+size_t szf_bench_bytes_value(SzfBytes bytes);
+size_t szf_bench_bytes_ptr(const SzfBytes* bytes);
+
+#define MAX_RESULTS 32
+#define DEFAULT_ITERATIONS 1000000UL
+#define RESET_INTERVAL 1024UL
+
+typedef struct {
+    const char* name;
+    const char* group;
+    unsigned long iterations;
+    double ns_per_call;
+} BenchResult;
+
+static BenchResult g_results[MAX_RESULTS];
+static size_t g_result_count = 0;
+
+// Sinks keep the optimiser from discarding results
+static volatile size_t g_sink;
+static volatile int32_t g_sink_i32;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void record(const char* group, const char* name, unsigned long iterations, uint64_t elapsed) {
+    if (g_result_count >= MAX_RESULTS) return;
+    BenchResult* r = &g_results[g_result_count++];
+    r->name = name;
+    r->group = group;
+    r->iterations = iterations;
+    r->ns_per_call = (double)elapsed / (double)iterations;
+}
+
+// Runs BODY `iters` times after a short warm-up and records ns/call
+#define BENCH(group, name, iters, BODY)                                  \
+    do {                                                                 \
+        unsigned long bench_n_ = (iters);                                \
+        for (unsigned long i = 0; i < bench_n_ / 16; i++) { BODY; }      \
+        uint64_t bench_t0_ = now_ns();                                   \
+        for (unsigned long i = 0; i < bench_n_; i++) { BODY; }           \
+        record((group), (name), bench_n_, now_ns() - bench_t0_);         \
+    } while (0)
+
+// ============================================================================
+// Callbacks
+// ============================================================================
+
+static void on_event(int32_t event_type, SzfBytes data, void* context) {
+    size_t* total = (size_t*)context;
+    *total += (size_t)event_type + data.len;
+}
+
+static bool on_progress(size_t current, size_t total, void* context) {
+    (void)total;
+    *(size_t*)context = current;
+    return true;
+}
+
+static void on_result(SzfResult result, void* context) {
+    *(int32_t*)context = result.code;
+}
+
+// ============================================================================
+// Benchmarks
+// ============================================================================
+
+static void bench_calls(unsigned long n) {
+    BENCH("call", "szf_bench_noop", n, szf_bench_noop());
+    BENCH("call", "szf_version", n, g_sink = szf_version());
+}
+
+static void bench_structs(unsigned long n) {
+    SzfBytes bytes = szf_bytes_from_raw((const uint8_t*)"payload", 7);
+    SzfResult out;
+
+    BENCH("struct", "result_by_value", n, {
+        SzfResult r = szf_bench_result_value((int32_t)(i & 1));
+        g_sink_i32 = r.code;
+    });
+    BENCH("struct", "result_pointer_out", n, {
+        szf_bench_result_out((int32_t)(i & 1), &out);
+        g_sink_i32 = out.code;
+    });
+    BENCH("struct", "bytes_by_value", n, g_sink = szf_bench_bytes_value(bytes));
+    BENCH("struct", "bytes_by_pointer", n, g_sink = szf_bench_bytes_ptr(&bytes));
+}
+
+static void bench_strings(SzfContext* ctx, unsigned long n) {
+    static const char key[] = "com.example.session.identifier";
+    const size_t key_len = sizeof(key) - 1;
+
+    BENCH("string", "szf_string_from_cstr", n, g_sink = szf_string_from_cstr(key).len);
+    BENCH("string", "szf_string_from_cstr_len", n, g_sink = szf_string_from_cstr_len(key, key_len).len);
+
+    int32_t handle = szf_string_intern(ctx, key, key_len);
+    BENCH("string", "szf_string_intern_hit", n, g_sink_i32 = szf_string_intern(ctx, key, key_len));
+    BENCH("string", "szf_string_interned", n, g_sink = szf_string_interned(ctx, handle).len);
+}
+
+static void bench_callbacks(SzfContext* ctx, unsigned long n) {
+    size_t total = 0;
+    SzfBytes empty = szf_bytes_empty();
+
+    szf_register_event_callback(on_event, &total);
+    BENCH("callback", "szf_invoke_event_global", n, szf_invoke_event(1, empty));
+    szf_register_event_callback(NULL, NULL);
+
+    szf_context_register_event_callback(ctx, on_event, &total);
+    BENCH("callback", "szf_context_invoke_event", n, szf_context_invoke_event(ctx, 1, empty));
+    BENCH("callback", "szf_context_register_event_callback", n,
+          szf_context_register_event_callback(ctx, on_event, &total));
+    szf_context_register_event_callback(ctx, NULL, NULL);
+
+    g_sink = total;
+}
+
+static void bench_processing(unsigned long n) {
+    static uint8_t data[4096];
+    memset(data, 'a', sizeof(data));
+    SzfBytes input = szf_bytes_from_raw(data, sizeof(data));
+    SzfBytes small = szf_bytes_from_raw(data, 64);
+    SzfBytes out;
+
+    SzfContext* arena = szf_context_new_ex(SZF_ALLOC_ARENA);
+    SzfContext* slab = szf_context_new_ex(SZF_ALLOC_SLAB);
+    if (!arena || !slab) {
+        fprintf(stderr, "bench: context creation failed\n");
+        exit(1);
+    }
+
+    size_t progress = 0;
+    int32_t code = 0;
+    /* At least one run: record() divides by the count */
+    unsigned long process_n = n >= 16 ? n / 16 : 1;
+    BENCH("process", "szf_process_data_4k_4_callbacks", process_n,
+          g_sink_i32 = szf_process_data(arena, input, on_progress, &progress, on_result, &code));
+
+    BENCH("alloc", "szf_transform_data_64b_arena", n, {
+        g_sink_i32 = szf_transform_data(arena, small, &out);
+        if ((i % RESET_INTERVAL) == 0) szf_context_reset(arena);
+    });
+    BENCH("alloc", "szf_transform_data_64b_slab_release", n, {
+        g_sink_i32 = szf_transform_data(slab, small, &out);
+        szf_context_release_bytes(slab, &out);
+    });
+
+    SzfAllocStats stats;
+    szf_context_get_stats(slab, &stats);
+    g_sink = (size_t)stats.slab_hits;
+
+    szf_context_free(slab);
+    szf_context_free(arena);
+}
+
+// ============================================================================
+// Output
+// ============================================================================
+
+static void write_json(FILE* out, unsigned long iterations) {
+    unsigned ver = szf_version();
+    fprintf(out, "{\n");
+    fprintf(out, "  \"library_version\": \"%u.%u.%u\",\n", (ver >> 16) & 0xFF, (ver >> 8) & 0xFF, ver & 0xFF);
+    fprintf(out, "  \"iterations\": %lu,\n", iterations);
+    fprintf(out, "  \"results\": [\n");
+    for (size_t i = 0; i < g_result_count; i++) {
+        const BenchResult* r = &g_results[i];
+        fprintf(out, "    {\"group\": \"%s\", \"name\": \"%s\", \"iterations\": %lu, \"ns_per_call\": %.3f}%s\n",
+                r->group, r->name, r->iterations, r->ns_per_call,
+                i + 1 < g_result_count ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+int main(int argc, char** argv) {
+    const char* out_path = argc > 1 ? argv[1] : NULL;
+    unsigned long iterations = DEFAULT_ITERATIONS;
+    const char* env_iters = getenv("SZF_BENCH_ITERATIONS");
+    if (env_iters) {
+        unsigned long parsed = strtoul(env_iters, NULL, 10);
+        if (parsed > 0) iterations = parsed;
+    }
+
+    SzfContext* ctx = szf_context_new();
+    if (!ctx) {
+        fprintf(stderr, "bench: context creation failed\n");
+        return 1;
+    }
+
+    bench_calls(iterations);
+    bench_structs(iterations);
+    bench_strings(ctx, iterations);
+    bench_callbacks(ctx, iterations);
+    bench_processing(iterations);
+
+    szf_context_free(ctx);
+
+    FILE* out = stdout;
+    if (out_path) {
+        out = fopen(out_path, "w");
+        if (!out) {
+            perror(out_path);
+            return 1;
+        }
+    }
+    write_json(out, iterations);
+    if (out != stdout) fclose(out);
+
+    return 0;
+}
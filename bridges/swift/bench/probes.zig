@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//! Swift-Zig FFI - Benchmark Probes
+//!
+//! Root of the benchmark library. Pulls in every szf_* export from lib.zig
+//! and adds a few bench-only exports that isolate calling-convention cost:
+//! the same payload returned by value vs written through a pointer, and
+//! passed by value vs by pointer. Not part of the shipped library.
+
+const ffi = @import("swift_zig_ffi");
+
+comptime {
+    _ = ffi;
+}
+
+/// Empty call: baseline for FFI crossing cost
+export fn szf_bench_noop() callconv(.c) void {}
+
+/// SzfResult (40 bytes) returned by value (hidden return pointer on most ABIs)
+export fn szf_bench_result_value(code: i32) callconv(.c) ffi.SzfResult {
+    if (code != ffi.SZF_OK) return ffi.SzfResult.err(code, null);
+    return ffi.SzfResult.ok(ffi.SzfBytes.empty());
+}
+
+/// SzfResult written through a caller-provided pointer
+export fn szf_bench_result_out(code: i32, out: *ffi.SzfResult) callconv(.c) void {
+    out.* = if (code != ffi.SZF_OK) ffi.SzfResult.err(code, null) else ffi.SzfResult.ok(ffi.SzfBytes.empty());
+}
+
+/// SzfBytes (32 bytes) passed by value
+export fn szf_bench_bytes_value(bytes: ffi.SzfBytes) callconv(.c) usize {
+    return bytes.len;
+}
+
+/// SzfBytes passed by pointer
+export fn szf_bench_bytes_ptr(bytes: *const ffi.SzfBytes) callconv(.c) usize {
+    return bytes.len;
+}
@@ -8,6 +8,7 @@
 //!   zig build -Dtarget=x86_64-ios-simulator  # iOS Simulator
 //!   zig build test               # Run tests
 //!   zig build gen-header         # Generate Swift bridging header
+//!   zig build bench [-- out.json]  # Measure FFI boundary cost (JSON)
 
 const std = @import("std");
 
@@ -71,4 +72,46 @@ pub fn build(b: *std.Build) void {
 
     const gen_header_step = b.step("gen-header", "Generate Swift bridging header");
     gen_header_step.dependOn(&run_gen_header.step);
+
+    // Benchmarks: C driver calling through SwiftZigFFI.h, always optimised
+    const bench_lib = b.addLibrary(.{
+        .name = "swift_zig_ffi_bench",
+        .root_module = b.createModule(.{
+            .root_source_file = b.path("bench/probes.zig"),
+            .target = target,
+            .optimize = .ReleaseFast,
+            .imports = &.{
+                .{
+                    .name = "swift_zig_ffi",
+                    .module = b.createModule(.{
+                        .root_source_file = b.path("src/lib.zig"),
+                        .target = target,
+                        .optimize = .ReleaseFast,
+                    }),
+                },
+            },
+        }),
+        .linkage = .static,
+    });
+
+    const bench_exe = b.addExecutable(.{
+        .name = "szf_bench",
+        .root_module = b.createModule(.{
+            .target = target,
+            .optimize = .ReleaseFast,
+            .link_libc = true,
+        }),
+    });
+    bench_exe.root_module.addCSourceFile(.{
+        .file = b.path("bench/bench.c"),
+        .flags = &.{ "-std=c11", "-O2", "-Wall", "-Wextra" },
+    });
+    bench_exe.root_module.addIncludePath(b.path("include"));
+    bench_exe.root_module.linkLibrary(bench_lib);
+
+    const run_bench = b.addRunArtifact(bench_exe);
+    if (b.args) |args| run_bench.addArgs(args);
+
+    const bench_step = b.step("bench", "Run FFI boundary benchmarks (JSON output)");
+    bench_step.dependOn(&run_bench.step);
 }
@@ -21,8 +21,13 @@ const SZF_ERR_INVALID_LENGTH: i32 = -4;
 const SZF_ERR_NOT_FOUND: i32 = -5;
 const SZF_ERR_ALREADY_EXISTS: i32 = -6;
 const SZF_ERR_CALLBACK_FAILED: i32 = -7;
+const SZF_ERR_IO: i32 = -8;
 const SZF_ERR_NOT_IMPLEMENTED: i32 = -99;
 
+// Allocator modes - MUST match lib.zig
+const SZF_ALLOC_ARENA: i32 = 0;
+const SZF_ALLOC_SLAB: i32 = 1;
+
 pub fn main() !void {
     var gpa = std.heap.GeneralPurposeAllocator(.{}){};
     defer _ = gpa.deinit();
@@ -99,9 +104,17 @@ fn generateHeader() []const u8 {
         \\#define SZF_ERR_NOT_FOUND       {d}
         \\#define SZF_ERR_ALREADY_EXISTS  {d}
         \\#define SZF_ERR_CALLBACK_FAILED {d}
+        \\#define SZF_ERR_IO              {d}
         \\#define SZF_ERR_NOT_IMPLEMENTED {d}
         \\
         \\// ============================================================================
+        \\// Allocator Modes (szf_context_new_ex)
+        \\// ============================================================================
+        \\
+        \\#define SZF_ALLOC_ARENA         {d}  ///< One arena, reclaimed on reset
+        \\#define SZF_ALLOC_SLAB          {d}  ///< Size-class slabs with individual free
+        \\
+        \\// ============================================================================
         \\// Types
         \\// ============================================================================
         \\
@@ -129,6 +142,17 @@ fn generateHeader() []const u8 {
         \\    SzfBytes data;        ///< Result data (if successful)
         \\}} SzfResult;
         \\
+        \\/// Allocator statistics for a context
+        \\typedef struct {{
+        \\    int32_t mode;           ///< SZF_ALLOC_* mode of the context
+        \\    size_t bytes_live;      ///< Bytes currently allocated
+        \\    size_t bytes_peak;      ///< High-water mark of bytes_live
+        \\    size_t bytes_reserved;  ///< Bytes held from the system
+        \\    uint64_t slab_hits;     ///< Allocations served from a free list
+        \\    uint64_t slab_misses;   ///< Allocations that carved a fresh block
+        \\    uint64_t large_allocs;  ///< Allocations above the largest size class
+        \\}} SzfAllocStats;
+        \\
         \\// ============================================================================
         \\// Callback Types
         \\// ============================================================================
@@ -158,6 +182,10 @@ fn generateHeader() []const u8 {
         \\/// Create a new context. Returns NULL on failure.
         \\SzfContext* szf_context_new(void);
         \\
+        \\/// Create a new context with an allocator mode (SZF_ALLOC_*).
+        \\/// Returns NULL on failure or unknown mode.
+        \\SzfContext* szf_context_new_ex(int32_t allocator_mode);
+        \\
         \\/// Free a context and all its allocations. Safe to call with NULL.
         \\void szf_context_free(SzfContext* ctx);
         \\
@@ -167,6 +195,13 @@ fn generateHeader() []const u8 {
         \\/// Get last error message from context
         \\const char* szf_context_get_error(SzfContext* ctx);
         \\
+        \\/// Get allocator statistics for a context
+        \\int32_t szf_context_get_stats(SzfContext* ctx, SzfAllocStats* out);
+        \\
+        \\/// Release a context-owned buffer (e.g. from szf_transform_data) before
+        \\/// the next reset. Reused immediately in slab mode.
+        \\void szf_context_release_bytes(SzfContext* ctx, SzfBytes* bytes);
+        \\
         \\// ============================================================================
         \\// String/Bytes Operations
         \\// ============================================================================
@@ -174,6 +209,18 @@ fn generateHeader() []const u8 {
         \\/// Create string wrapper from C string
         \\SzfString szf_string_from_cstr(const char* cstr);
         \\
+        \\/// Create string wrapper from C string with known length (no strlen scan).
+        \\/// cstr[len] must be the NUL terminator.
+        \\SzfString szf_string_from_cstr_len(const char* cstr, size_t len);
+        \\
+        \\/// Intern a string in the context. Returns a stable handle (>= 0) or a
+        \\/// negative error code. Equal bytes always map to the same handle.
+        \\int32_t szf_string_intern(SzfContext* ctx, const char* ptr, size_t len);
+        \\
+        \\/// Look up an interned string. Valid until the context is freed
+        \\/// (survives szf_context_reset). Empty if the handle is unknown.
+        \\SzfString szf_string_interned(SzfContext* ctx, int32_t handle);
+        \\
         \\/// Free an owned string
         \\void szf_string_free(SzfString* str);
         \\
@@ -190,6 +237,21 @@ fn generateHeader() []const u8 {
         \\/// Register error callback. Pass NULL to unregister.
         \\void szf_register_error_callback(SzfErrorCallback callback, void* context);
         \\
+        \\/// Register event callback on one context only. Pass NULL to unregister.
+        \\/// Safe to call while other threads are dispatching on the same context.
+        \\int32_t szf_context_register_event_callback(
+        \\    SzfContext* ctx,
+        \\    SzfEventCallback callback,
+        \\    void* context
+        \\);
+        \\
+        \\/// Register error callback on one context only. Pass NULL to unregister.
+        \\int32_t szf_context_register_error_callback(
+        \\    SzfContext* ctx,
+        \\    SzfErrorCallback callback,
+        \\    void* context
+        \\);
+        \\
         \\// ============================================================================
         \\// Callback Invocation (Zig calls these to notify Swift)
         \\// ============================================================================
@@ -200,6 +262,12 @@ fn generateHeader() []const u8 {
         \\/// Invoke error callback (internal use or testing)
         \\void szf_invoke_error(int32_t code, const char* message);
         \\
+        \\/// Invoke a context's event callback
+        \\void szf_context_invoke_event(SzfContext* ctx, int32_t event_type, SzfBytes data);
+        \\
+        \\/// Invoke a context's error callback
+        \\void szf_context_invoke_error(SzfContext* ctx, int32_t code, const char* message);
+        \\
         \\// ============================================================================
         \\// Data Processing
         \\// ============================================================================
@@ -214,6 +282,29 @@ fn generateHeader() []const u8 {
         \\    void* result_ctx
         \\);
         \\
+        \\/// Process everything readable from a file descriptor (not closed),
+        \\/// starting at its current offset and leaving it at end of file.
+        \\/// Regular files with >= 1 MiB left are memory-mapped, anything else is
+        \\/// streamed. Progress is in bytes; total is 0 when the size is unknown.
+        \\int32_t szf_process_fd(
+        \\    SzfContext* ctx,
+        \\    int fd,
+        \\    SzfProgressCallback progress_cb,
+        \\    void* progress_ctx,
+        \\    SzfResultCallback result_cb,
+        \\    void* result_ctx
+        \\);
+        \\
+        \\/// Open a file read-only and process it with szf_process_fd
+        \\int32_t szf_process_path(
+        \\    SzfContext* ctx,
+        \\    const char* path,
+        \\    SzfProgressCallback progress_cb,
+        \\    void* progress_ctx,
+        \\    SzfResultCallback result_cb,
+        \\    void* result_ctx
+        \\);
+        \\
         \\/// Transform data (example: uppercase ASCII)
         \\int32_t szf_transform_data(
         \\    SzfContext* ctx,
@@ -265,7 +356,11 @@ fn generateHeader() []const u8 {
         SZF_ERR_NOT_FOUND,
         SZF_ERR_ALREADY_EXISTS,
         SZF_ERR_CALLBACK_FAILED,
+        SZF_ERR_IO,
         SZF_ERR_NOT_IMPLEMENTED,
+        // Allocator modes
+        SZF_ALLOC_ARENA,
+        SZF_ALLOC_SLAB,
     });
 }
 
@@ -11,6 +11,8 @@
 //! - iOS/macOS/watchOS/tvOS compatible
 
 const std = @import("std");
+const builtin = @import("builtin");
+const slab = @import("slab.zig");
 
 // ============================================================================
 // ABI Version
@@ -33,8 +35,18 @@ pub const SZF_ERR_INVALID_LENGTH: i32 = -4;
 pub const SZF_ERR_NOT_FOUND: i32 = -5;
 pub const SZF_ERR_ALREADY_EXISTS: i32 = -6;
 pub const SZF_ERR_CALLBACK_FAILED: i32 = -7;
+pub const SZF_ERR_IO: i32 = -8;
 pub const SZF_ERR_NOT_IMPLEMENTED: i32 = -99;
 
+// ============================================================================
+// Allocator Modes
+// ============================================================================
+
+/// Single arena per context; memory is reclaimed only by szf_context_reset
+pub const SZF_ALLOC_ARENA: i32 = 0;
+/// Size-class slabs with individual free; suited to long-lived contexts
+pub const SZF_ALLOC_SLAB: i32 = 1;
+
 // ============================================================================
 // FFI-Safe Types
 // ============================================================================
@@ -87,6 +99,24 @@ pub const SzfString = extern struct {
     }
 };
 
+/// Allocator statistics for a context
+pub const SzfAllocStats = extern struct {
+    /// Allocator mode the context was created with
+    mode: i32,
+    /// Bytes currently allocated (arena mode: bytes held by the arena)
+    bytes_live: usize,
+    /// High-water mark of bytes_live
+    bytes_peak: usize,
+    /// Bytes held from the system
+    bytes_reserved: usize,
+    /// Small allocations served from a free list (slab mode only)
+    slab_hits: u64,
+    /// Small allocations that carved a fresh block (slab mode only)
+    slab_misses: u64,
+    /// Allocations above the largest size class (slab mode only)
+    large_allocs: u64,
+};
+
 /// Result type for operations that return data or error
 pub const SzfResult = extern struct {
     /// Error code (0 = success)
@@ -125,49 +155,233 @@ pub const SzfEventCallback = *const fn (event_type: i32, data: SzfBytes, context
 pub const SzfErrorCallback = *const fn (code: i32, message: ?[*:0]const u8, context: ?*anyopaque) callconv(.c) void;
 
 // ============================================================================
-// Global Callback Storage
+// Callback Storage
+// ============================================================================
+
+/// A callback plus its user context, published atomically as a pair.
+///
+/// Writers are serialised by a sequence counter (odd while a write is in
+/// flight); readers never block and retry if they observe a torn pair.
+/// This lets one thread re-register while others keep dispatching.
+pub fn AtomicCallback(comptime Fn: type) type {
+    return struct {
+        seq: std.atomic.Value(usize) = std.atomic.Value(usize).init(0),
+        func: std.atomic.Value(usize) = std.atomic.Value(usize).init(0),
+        context: std.atomic.Value(usize) = std.atomic.Value(usize).init(0),
+
+        const Self = @This();
+
+        pub const Snapshot = struct {
+            func: ?Fn,
+            context: ?*anyopaque,
+        };
+
+        pub fn store(self: *Self, func: ?Fn, context: ?*anyopaque) void {
+            // Acquire the write side by moving seq from even to odd
+            var seq = self.seq.load(.monotonic);
+            while (true) {
+                if (seq & 1 != 0) {
+                    std.atomic.spinLoopHint();
+                    seq = self.seq.load(.monotonic);
+                    continue;
+                }
+                seq = self.seq.cmpxchgWeak(seq, seq + 1, .acquire, .monotonic) orelse break;
+            }
+
+            self.func.store(if (func) |f| @intFromPtr(f) else 0, .release);
+            self.context.store(@intFromPtr(context), .release);
+            self.seq.store(seq + 2, .release);
+        }
+
+        pub fn load(self: *const Self) Snapshot {
+            while (true) {
+                const before = self.seq.load(.acquire);
+                if (before & 1 != 0) {
+                    std.atomic.spinLoopHint();
+                    continue;
+                }
+                const func = self.func.load(.acquire);
+                const context = self.context.load(.acquire);
+                if (self.seq.load(.monotonic) != before) continue;
+
+                return .{
+                    .func = if (func != 0) @ptrFromInt(func) else null,
+                    .context = @ptrFromInt(context),
+                };
+            }
+        }
+    };
+}
+
+/// Zig → Swift notification callbacks.
+/// Each SzfContext owns one table; a process-wide table backs the
+/// context-less szf_register_*/szf_invoke_* entry points.
+pub const SzfCallbackTable = struct {
+    event: AtomicCallback(SzfEventCallback) = .{},
+    err: AtomicCallback(SzfErrorCallback) = .{},
+
+    pub fn invokeEvent(self: *const SzfCallbackTable, event_type: i32, data: SzfBytes) void {
+        const snap = self.event.load();
+        if (snap.func) |cb| cb(event_type, data, snap.context);
+    }
+
+    pub fn invokeError(self: *const SzfCallbackTable, code: i32, message: ?[*:0]const u8) void {
+        const snap = self.err.load();
+        if (snap.func) |cb| cb(code, message, snap.context);
+    }
+};
+
+var g_callbacks: SzfCallbackTable = .{};
+
+// ============================================================================
+// String Interning
 // ============================================================================
 
-var g_event_callback: ?SzfEventCallback = null;
-var g_event_context: ?*anyopaque = null;
-var g_error_callback: ?SzfErrorCallback = null;
-var g_error_context: ?*anyopaque = null;
+/// Interned string table. Each distinct string is copied once (with a NUL
+/// terminator) and handed out as a stable integer handle. Entries live until
+/// the owning context is freed; szf_context_reset does not touch them.
+///
+/// Only the string bytes go in the arena. The map and handle list are
+/// resized through `tables`, a general-purpose allocator, so a rehash frees
+/// the old table instead of leaving it in the arena until the context is
+/// freed, and small growth does not map whole pages.
+pub const StringInterner = struct {
+    tables: std.mem.Allocator,
+    arena: std.heap.ArenaAllocator,
+    index: std.StringHashMapUnmanaged(u32),
+    strings: std.ArrayListUnmanaged(SzfString),
+
+    pub fn init(tables: std.mem.Allocator, bytes_backing: std.mem.Allocator) StringInterner {
+        return .{
+            .tables = tables,
+            .arena = std.heap.ArenaAllocator.init(bytes_backing),
+            .index = .{},
+            .strings = .{},
+        };
+    }
+
+    pub fn deinit(self: *StringInterner) void {
+        self.index.deinit(self.tables);
+        self.strings.deinit(self.tables);
+        self.arena.deinit();
+    }
+
+    /// Return the handle for `bytes`, copying it in on first sight
+    pub fn intern(self: *StringInterner, bytes: []const u8) !u32 {
+        const entry = try self.index.getOrPut(self.tables, bytes);
+        if (entry.found_existing) return entry.value_ptr.*;
+
+        errdefer _ = self.index.remove(bytes);
+        if (self.strings.items.len >= std.math.maxInt(i32)) return error.OutOfMemory;
+
+        const copy = try self.arena.allocator().dupeZ(u8, bytes);
+        const handle: u32 = @intCast(self.strings.items.len);
+        try self.strings.append(self.tables, SzfString.fromSlice(copy));
+
+        // Re-key on the owned copy so the caller's buffer can go away
+        entry.key_ptr.* = copy;
+        entry.value_ptr.* = handle;
+        return handle;
+    }
+
+    pub fn get(self: *const StringInterner, handle: u32) ?SzfString {
+        if (handle >= self.strings.items.len) return null;
+        return self.strings.items[handle];
+    }
+
+    pub fn count(self: *const StringInterner) usize {
+        return self.strings.items.len;
+    }
+};
 
 // ============================================================================
 // Context Management
 // ============================================================================
 
+var gpa = std.heap.GeneralPurposeAllocator(.{}){};
+
+/// Allocator for small, frequently resized context bookkeeping (interner
+/// tables): libc malloc when linked, else a process-wide GPA. Arenas and
+/// slabs keep using page_allocator for their large chunks.
+fn generalAllocator() std.mem.Allocator {
+    return if (builtin.link_libc) std.heap.c_allocator else gpa.allocator();
+}
+
 /// Opaque context for library state
 pub const SzfContext = struct {
     allocator: std.mem.Allocator,
+    mode: i32,
     arena: std.heap.ArenaAllocator,
+    slab: slab.SlabAllocator,
+    /// Arena-mode high-water mark, sampled on reset and stats queries
+    arena_peak: usize,
     error_buf: [512]u8,
     error_msg: ?[*:0]const u8,
+    callbacks: SzfCallbackTable,
+    strings: StringInterner,
+
+    pub fn init(mode: i32) !*SzfContext {
+        if (mode != SZF_ALLOC_ARENA and mode != SZF_ALLOC_SLAB) return error.InvalidMode;
 
-    pub fn init() !*SzfContext {
         const backing = std.heap.page_allocator;
         const ctx = try backing.create(SzfContext);
         ctx.* = .{
             .allocator = backing,
+            .mode = mode,
             .arena = std.heap.ArenaAllocator.init(backing),
+            .slab = slab.SlabAllocator.init(backing),
+            .arena_peak = 0,
             .error_buf = undefined,
             .error_msg = null,
+            .callbacks = .{},
+            .strings = StringInterner.init(generalAllocator(), backing),
         };
         return ctx;
     }
 
     pub fn deinit(self: *SzfContext) void {
+        self.strings.deinit();
+        self.slab.deinit();
         self.arena.deinit();
         self.allocator.destroy(self);
     }
 
     pub fn reset(self: *SzfContext) void {
+        self.arena_peak = @max(self.arena_peak, self.arena.queryCapacity());
         _ = self.arena.reset(.retain_capacity);
+        self.slab.reset();
         self.error_msg = null;
     }
 
     pub fn alloc(self: *SzfContext) std.mem.Allocator {
-        return self.arena.allocator();
+        return if (self.mode == SZF_ALLOC_SLAB) self.slab.allocator() else self.arena.allocator();
+    }
+
+    pub fn stats(self: *SzfContext) SzfAllocStats {
+        if (self.mode == SZF_ALLOC_SLAB) {
+            const s = self.slab.stats;
+            return .{
+                .mode = self.mode,
+                .bytes_live = s.bytes_live,
+                .bytes_peak = s.bytes_peak,
+                .bytes_reserved = s.bytes_reserved,
+                .slab_hits = s.slab_hits,
+                .slab_misses = s.slab_misses,
+                .large_allocs = s.large_allocs,
+            };
+        }
+
+        const held = self.arena.queryCapacity();
+        self.arena_peak = @max(self.arena_peak, held);
+        return .{
+            .mode = self.mode,
+            .bytes_live = held,
+            .bytes_peak = self.arena_peak,
+            .bytes_reserved = held,
+            .slab_hits = 0,
+            .slab_misses = 0,
+            .large_allocs = 0,
+        };
     }
 
     pub fn setError(self: *SzfContext, msg: []const u8) void {
@@ -189,7 +403,12 @@ export fn szf_version() callconv(.c) u32 {
 
 /// Create a new context
 export fn szf_context_new() callconv(.c) ?*SzfContext {
-    return SzfContext.init() catch null;
+    return SzfContext.init(SZF_ALLOC_ARENA) catch null;
+}
+
+/// Create a new context with an explicit allocator mode (SZF_ALLOC_*)
+export fn szf_context_new_ex(allocator_mode: i32) callconv(.c) ?*SzfContext {
+    return SzfContext.init(allocator_mode) catch null;
 }
 
 /// Free a context
@@ -202,6 +421,26 @@ export fn szf_context_reset(ctx: ?*SzfContext) callconv(.c) void {
     if (ctx) |c| c.reset();
 }
 
+/// Get allocator statistics for a context
+export fn szf_context_get_stats(ctx: ?*SzfContext, out: ?*SzfAllocStats) callconv(.c) i32 {
+    const c = ctx orelse return SZF_ERR_NULL_PTR;
+    const o = out orelse return SZF_ERR_NULL_PTR;
+    o.* = c.stats();
+    return SZF_OK;
+}
+
+/// Release a buffer returned by a context-owned operation (for example
+/// szf_transform_data) before the next reset. In slab mode the memory is
+/// reused immediately; in arena mode only the most recent buffer is reclaimed.
+export fn szf_context_release_bytes(ctx: ?*SzfContext, bytes: ?*SzfBytes) callconv(.c) void {
+    const c = ctx orelse return;
+    const b = bytes orelse return;
+    if (b.ptr) |p| {
+        if (b.cap > 0) c.alloc().free(@constCast(p[0..b.cap]));
+    }
+    b.* = SzfBytes.empty();
+}
+
 /// Get last error message
 export fn szf_context_get_error(ctx: ?*SzfContext) callconv(.c) ?[*:0]const u8 {
     if (ctx) |c| return c.error_msg;
@@ -219,6 +458,35 @@ export fn szf_string_from_cstr(cstr: ?[*:0]const u8) callconv(.c) SzfString {
     return .{ .ptr = ptr, .len = len };
 }
 
+/// Create string wrapper from C string with a known length (no strlen scan).
+/// `cstr[len]` must be the NUL terminator.
+export fn szf_string_from_cstr_len(cstr: ?[*:0]const u8, len: usize) callconv(.c) SzfString {
+    const ptr = cstr orelse return SzfString.empty();
+    return .{ .ptr = ptr, .len = len };
+}
+
+/// Intern a string in the context and return its stable handle (>= 0),
+/// or a negative error code. Repeated calls with equal bytes return the
+/// same handle. `ptr` need not be NUL-terminated.
+export fn szf_string_intern(ctx: ?*SzfContext, ptr: ?[*]const u8, len: usize) callconv(.c) i32 {
+    const c = ctx orelse return SZF_ERR_NULL_PTR;
+    const bytes: []const u8 = if (ptr) |p| p[0..len] else if (len == 0) "" else return SZF_ERR_NULL_PTR;
+
+    const handle = c.strings.intern(bytes) catch {
+        c.setError("string intern failed");
+        return SZF_ERR_ALLOC_FAILED;
+    };
+    return @intCast(handle);
+}
+
+/// Look up an interned string by handle. Returns an empty string if the
+/// handle is unknown. The result stays valid until the context is freed.
+export fn szf_string_interned(ctx: ?*SzfContext, handle: i32) callconv(.c) SzfString {
+    const c = ctx orelse return SzfString.empty();
+    if (handle < 0) return SzfString.empty();
+    return c.strings.get(@intCast(handle)) orelse SzfString.empty();
+}
+
 /// Free an owned string
 export fn szf_string_free(str: *SzfString) callconv(.c) void {
     str.* = SzfString.empty();
@@ -244,8 +512,7 @@ export fn szf_register_event_callback(
     callback: ?SzfEventCallback,
     context: ?*anyopaque,
 ) callconv(.c) void {
-    g_event_callback = callback;
-    g_event_context = context;
+    g_callbacks.event.store(callback, context);
 }
 
 /// Register error callback (Zig will call this to notify Swift of errors)
@@ -253,8 +520,29 @@ export fn szf_register_error_callback(
     callback: ?SzfErrorCallback,
     context: ?*anyopaque,
 ) callconv(.c) void {
-    g_error_callback = callback;
-    g_error_context = context;
+    g_callbacks.err.store(callback, context);
+}
+
+/// Register event callback on a single context
+export fn szf_context_register_event_callback(
+    ctx: ?*SzfContext,
+    callback: ?SzfEventCallback,
+    context: ?*anyopaque,
+) callconv(.c) i32 {
+    const c = ctx orelse return SZF_ERR_NULL_PTR;
+    c.callbacks.event.store(callback, context);
+    return SZF_OK;
+}
+
+/// Register error callback on a single context
+export fn szf_context_register_error_callback(
+    ctx: ?*SzfContext,
+    callback: ?SzfErrorCallback,
+    context: ?*anyopaque,
+) callconv(.c) i32 {
+    const c = ctx orelse return SZF_ERR_NULL_PTR;
+    c.callbacks.err.store(callback, context);
+    return SZF_OK;
 }
 
 // ============================================================================
@@ -263,22 +551,79 @@ export fn szf_register_error_callback(
 
 /// Invoke event callback (called from Zig to notify Swift)
 export fn szf_invoke_event(event_type: i32, data: SzfBytes) callconv(.c) void {
-    if (g_event_callback) |cb| {
-        cb(event_type, data, g_event_context);
-    }
+    g_callbacks.invokeEvent(event_type, data);
 }
 
 /// Invoke error callback (called from Zig to notify Swift)
 export fn szf_invoke_error(code: i32, message: ?[*:0]const u8) callconv(.c) void {
-    if (g_error_callback) |cb| {
-        cb(code, message, g_error_context);
-    }
+    g_callbacks.invokeError(code, message);
+}
+
+/// Invoke a context's event callback
+export fn szf_context_invoke_event(ctx: ?*SzfContext, event_type: i32, data: SzfBytes) callconv(.c) void {
+    if (ctx) |c| c.callbacks.invokeEvent(event_type, data);
+}
+
+/// Invoke a context's error callback
+export fn szf_context_invoke_error(ctx: ?*SzfContext, code: i32, message: ?[*:0]const u8) callconv(.c) void {
+    if (ctx) |c| c.callbacks.invokeError(code, message);
 }
 
 // ============================================================================
 // Example: Data Processing with Callbacks
 // ============================================================================
 
+/// Chunk size for in-memory processing
+const process_chunk_size: usize = 1024;
+
+/// Files at least this large are memory-mapped by szf_process_fd;
+/// smaller files, pipes and sockets are streamed through a read buffer
+pub const SZF_MMAP_THRESHOLD: usize = 1024 * 1024;
+
+/// Read size when streaming from a descriptor
+const stream_chunk_size: usize = 64 * 1024;
+
+/// Mapped bytes fed per step; consumed windows are released afterwards
+/// so resident memory stays bounded on multi-GB inputs
+const mmap_window_size: usize = 4 * 1024 * 1024;
+
+/// Shared chunk pipeline behind every szf_process_* entry point.
+/// Tracks bytes processed and drives the progress callback.
+const ChunkPipeline = struct {
+    processed: usize = 0,
+    /// Total bytes expected, or 0 if unknown (pipes, sockets)
+    total: usize,
+    progress_cb: ?SzfProgressCallback,
+    progress_ctx: ?*anyopaque,
+
+    /// Feed one chunk; returns false if the caller cancelled
+    fn feed(self: *ChunkPipeline, chunk: []const u8) bool {
+        // Saturates instead of wrapping on 32-bit targets past 4 GiB
+        self.processed +|= chunk.len;
+        if (self.progress_cb) |cb| {
+            return cb(self.processed, self.total, self.progress_ctx);
+        }
+        return true;
+    }
+};
+
+const StreamOutcome = enum { done, cancelled };
+
+/// Record an error on the context and forward it to the result callback
+fn failProcess(
+    c: *SzfContext,
+    code: i32,
+    msg: []const u8,
+    result_cb: ?SzfResultCallback,
+    result_ctx: ?*anyopaque,
+) i32 {
+    c.setError(msg);
+    if (result_cb) |cb| {
+        cb(SzfResult.err(code, c.error_msg), result_ctx);
+    }
+    return code;
+}
+
 /// Process data with progress callback (demonstrates Swift → Zig callback)
 export fn szf_process_data(
     ctx: ?*SzfContext,
@@ -292,42 +637,171 @@ export fn szf_process_data(
     const data = input.toSlice();
 
     if (data.len == 0) {
-        c.setError("empty input data");
-        if (result_cb) |cb| {
-            cb(SzfResult.err(SZF_ERR_INVALID_LENGTH, c.error_msg), result_ctx);
+        return failProcess(c, SZF_ERR_INVALID_LENGTH, "empty input data", result_cb, result_ctx);
+    }
+
+    var pipeline = ChunkPipeline{
+        .total = data.len,
+        .progress_cb = progress_cb,
+        .progress_ctx = progress_ctx,
+    };
+
+    var offset: usize = 0;
+    while (offset < data.len) {
+        const end = @min(offset + process_chunk_size, data.len);
+        if (!pipeline.feed(data[offset..end])) {
+            return failProcess(c, SZF_ERR_CALLBACK_FAILED, "cancelled by user", result_cb, result_ctx);
         }
-        return SZF_ERR_INVALID_LENGTH;
+        offset = end;
+    }
+
+    // Return result via callback
+    if (result_cb) |cb| {
+        cb(SzfResult.ok(input), result_ctx);
+    }
+
+    return SZF_OK;
+}
+
+/// Feed bytes [start, size) of `fd`. The mapping begins at the page
+/// holding `start`; the bytes before `start` in that page are skipped.
+fn streamMapped(pipeline: *ChunkPipeline, fd: std.posix.fd_t, start: usize, size: usize) !StreamOutcome {
+    const page = std.heap.pageSize();
+    const map_offset = std.mem.alignBackward(usize, start, page);
+    const mapped = try std.posix.mmap(null, size - map_offset, std.posix.PROT.READ, .{ .TYPE = .PRIVATE }, fd, map_offset);
+    defer std.posix.munmap(mapped);
+
+    std.posix.madvise(mapped.ptr, mapped.len, std.posix.MADV.SEQUENTIAL) catch {};
+
+    var offset: usize = start - map_offset;
+    while (offset < mapped.len) {
+        const end = @min(offset + mmap_window_size, mapped.len);
+        if (!pipeline.feed(mapped[offset..end])) return .cancelled;
+
+        // Clean private pages: dropping them just re-faults from page cache.
+        // Every byte of [page containing offset, end) has been fed by now.
+        const release = std.mem.alignBackward(usize, offset, page);
+        std.posix.madvise(@alignCast(mapped.ptr + release), end - release, std.posix.MADV.DONTNEED) catch {};
+        offset = end;
+    }
+    return .done;
+}
+
+fn streamRead(pipeline: *ChunkPipeline, fd: std.posix.fd_t, buf: []u8) !StreamOutcome {
+    if (builtin.os.tag == .linux) {
+        _ = std.os.linux.fadvise(fd, 0, 0, std.os.linux.POSIX_FADV.SEQUENTIAL);
+    }
+
+    while (true) {
+        const n = try std.posix.read(fd, buf);
+        if (n == 0) return .done;
+        if (!pipeline.feed(buf[0..n])) return .cancelled;
+    }
+}
+
+/// Process everything readable from a file descriptor, starting at its
+/// current position. Large regular files are memory-mapped; anything else
+/// is streamed. Either way the descriptor ends up at end of file.
+/// Progress is reported in bytes; `total` is the number of bytes from the
+/// current position to the end, or 0 when the size is unknown.
+/// The descriptor is not closed.
+export fn szf_process_fd(
+    ctx: ?*SzfContext,
+    fd: c_int,
+    progress_cb: ?SzfProgressCallback,
+    progress_ctx: ?*anyopaque,
+    result_cb: ?SzfResultCallback,
+    result_ctx: ?*anyopaque,
+) callconv(.c) i32 {
+    const c = ctx orelse return SZF_ERR_NULL_PTR;
+    if (fd < 0) {
+        return failProcess(c, SZF_ERR_IO, "invalid file descriptor", result_cb, result_ctx);
     }
 
-    // Simulate processing with progress
-    var processed: usize = 0;
-    const chunk_size: usize = 1024;
+    const st = std.posix.fstat(fd) catch {
+        return failProcess(c, SZF_ERR_IO, "fstat failed", result_cb, result_ctx);
+    };
+    const is_regular = std.posix.S.ISREG(st.mode);
+    // Null for pipes and sockets, and for regular files too large for
+    // usize (over 4 GiB on 32-bit targets): those are streamed with an
+    // unknown total instead of mapped
+    const file_size: ?usize = if (is_regular) std.math.cast(usize, st.size) else null;
+    // Match the read path, which continues from wherever the caller left off
+    const start: usize = if (file_size) |fs|
+        @min(std.posix.lseek_CUR_get(fd) catch 0, fs)
+    else
+        0;
+    const size = if (file_size) |fs| fs - start else 0;
+
+    if (file_size != null and size == 0) {
+        return failProcess(c, SZF_ERR_INVALID_LENGTH, "empty input data", result_cb, result_ctx);
+    }
 
-    while (processed < data.len) {
-        const remaining = data.len - processed;
-        const chunk = @min(remaining, chunk_size);
-        processed += chunk;
+    var pipeline = ChunkPipeline{
+        .total = size,
+        .progress_cb = progress_cb,
+        .progress_ctx = progress_ctx,
+    };
 
-        // Report progress
-        if (progress_cb) |cb| {
-            if (!cb(processed, data.len, progress_ctx)) {
-                c.setError("cancelled by user");
-                if (result_cb) |rcb| {
-                    rcb(SzfResult.err(SZF_ERR_CALLBACK_FAILED, c.error_msg), result_ctx);
+    const outcome = blk: {
+        if (file_size != null and size >= SZF_MMAP_THRESHOLD) {
+            if (streamMapped(&pipeline, fd, start, file_size.?)) |o| {
+                std.posix.lseek_SET(fd, file_size.?) catch {};
+                break :blk o;
+            } else |_| {
+                // mmap refused (e.g. special filesystem): fall back to reads
+                // unless the pipeline already consumed part of the mapping
+                if (pipeline.processed != 0) {
+                    return failProcess(c, SZF_ERR_IO, "mapped read failed", result_cb, result_ctx);
                 }
-                return SZF_ERR_CALLBACK_FAILED;
             }
         }
+
+        const buf = c.allocator.alloc(u8, stream_chunk_size) catch {
+            return failProcess(c, SZF_ERR_ALLOC_FAILED, "allocation failed", result_cb, result_ctx);
+        };
+        defer c.allocator.free(buf);
+
+        break :blk streamRead(&pipeline, fd, buf) catch {
+            return failProcess(c, SZF_ERR_IO, "read failed", result_cb, result_ctx);
+        };
+    };
+
+    if (outcome == .cancelled) {
+        return failProcess(c, SZF_ERR_CALLBACK_FAILED, "cancelled by user", result_cb, result_ctx);
+    }
+    if (pipeline.processed == 0) {
+        return failProcess(c, SZF_ERR_INVALID_LENGTH, "empty input data", result_cb, result_ctx);
     }
 
-    // Return result via callback
     if (result_cb) |cb| {
-        cb(SzfResult.ok(input), result_ctx);
+        cb(SzfResult.ok(SzfBytes.empty()), result_ctx);
     }
 
     return SZF_OK;
 }
 
+/// Open `path` read-only and process it with szf_process_fd
+export fn szf_process_path(
+    ctx: ?*SzfContext,
+    path: ?[*:0]const u8,
+    progress_cb: ?SzfProgressCallback,
+    progress_ctx: ?*anyopaque,
+    result_cb: ?SzfResultCallback,
+    result_ctx: ?*anyopaque,
+) callconv(.c) i32 {
+    const c = ctx orelse return SZF_ERR_NULL_PTR;
+    const p = path orelse return failProcess(c, SZF_ERR_NULL_PTR, "null path", result_cb, result_ctx);
+
+    const fd = std.posix.openZ(p, .{ .ACCMODE = .RDONLY, .CLOEXEC = true }, 0) catch |e| {
+        const code = if (e == error.FileNotFound) SZF_ERR_NOT_FOUND else SZF_ERR_IO;
+        return failProcess(c, code, "open failed", result_cb, result_ctx);
+    };
+    defer std.posix.close(fd);
+
+    return szf_process_fd(c, fd, progress_cb, progress_ctx, result_cb, result_ctx);
+}
+
 /// Transform data (example: uppercase ASCII)
 export fn szf_transform_data(
     ctx: ?*SzfContext,
@@ -359,7 +833,7 @@ export fn szf_transform_data(
         .ptr = result.ptr,
         .len = result.len,
         .cap = result.len,
-        .owned = 0, // Owned by context arena
+        .owned = 0, // Owned by context allocator
     };
 
     return SZF_OK;
@@ -399,3 +873,178 @@ test "transform data" {
     try std.testing.expectEqual(SZF_OK, result);
     try std.testing.expectEqualStrings("HELLO WORLD", output.toSlice());
 }
+
+test "per-context callbacks are independent" {
+    const Counter = struct {
+        fn onEvent(event_type: i32, data: SzfBytes, context: ?*anyopaque) callconv(.c) void {
+            _ = data;
+            const total: *i32 = @ptrCast(@alignCast(context.?));
+            total.* += event_type;
+        }
+    };
+
+    const a = szf_context_new().?;
+    defer szf_context_free(a);
+    const b = szf_context_new().?;
+    defer szf_context_free(b);
+
+    var total_a: i32 = 0;
+    var total_b: i32 = 0;
+    try std.testing.expectEqual(SZF_OK, szf_context_register_event_callback(a, Counter.onEvent, &total_a));
+    try std.testing.expectEqual(SZF_OK, szf_context_register_event_callback(b, Counter.onEvent, &total_b));
+
+    szf_context_invoke_event(a, 1, SzfBytes.empty());
+    szf_context_invoke_event(b, 10, SzfBytes.empty());
+    szf_context_invoke_event(b, 10, SzfBytes.empty());
+
+    try std.testing.expectEqual(@as(i32, 1), total_a);
+    try std.testing.expectEqual(@as(i32, 20), total_b);
+
+    // Unregistering one context leaves the other untouched
+    _ = szf_context_register_event_callback(a, null, null);
+    szf_context_invoke_event(a, 1, SzfBytes.empty());
+    szf_context_invoke_event(b, 1, SzfBytes.empty());
+    try std.testing.expectEqual(@as(i32, 1), total_a);
+    try std.testing.expectEqual(@as(i32, 21), total_b);
+}
+
+test "string interning returns stable handles" {
+    const ctx = szf_context_new().?;
+    defer szf_context_free(ctx);
+
+    var buf = "user_id".*;
+    const h1 = szf_string_intern(ctx, &buf, buf.len);
+    try std.testing.expect(h1 >= 0);
+
+    // Same bytes from a different buffer map to the same handle
+    const h2 = szf_string_intern(ctx, "user_id", 7);
+    try std.testing.expectEqual(h1, h2);
+
+    const h3 = szf_string_intern(ctx, "session", 7);
+    try std.testing.expect(h3 != h1);
+
+    // Interned copies survive caller mutation and context reset
+    buf[0] = 'X';
+    szf_context_reset(ctx);
+
+    const str = szf_string_interned(ctx, h1);
+    try std.testing.expectEqual(@as(usize, 7), str.len);
+    try std.testing.expectEqualStrings("user_id", std.mem.span(str.ptr.?));
+    try std.testing.expect(szf_string_interned(ctx, 99).ptr == null);
+}
+
+test "interner keeps only string bytes in its arena" {
+    var interner = StringInterner.init(std.testing.allocator, std.testing.allocator);
+    defer interner.deinit();
+
+    var name_buf: [16]u8 = undefined;
+    var string_bytes: usize = 0;
+    for (0..1000) |i| {
+        const name = try std.fmt.bufPrint(&name_buf, "s{d}", .{i});
+        try std.testing.expectEqual(@as(u32, @intCast(i)), try interner.intern(name));
+        string_bytes += name.len + 1;
+    }
+    try std.testing.expectEqual(@as(usize, 1000), interner.count());
+    try std.testing.expectEqualStrings("s999", std.mem.span(interner.get(999).?.ptr.?));
+
+    // Table growth is freed as it happens (std.testing.allocator checks the
+    // rest on deinit); the arena holds little beyond the strings themselves
+    try std.testing.expect(interner.arena.queryCapacity() <= 3 * string_bytes + 4096);
+}
+
+test "process fd streams file contents" {
+    const ctx = szf_context_new().?;
+    defer szf_context_free(ctx);
+
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+
+    const payload = "x" ** 5000;
+    try tmp.dir.writeFile(.{ .sub_path = "input.log", .data = payload });
+    const file = try tmp.dir.openFile("input.log", .{});
+    defer file.close();
+
+    const Progress = struct {
+        fn onProgress(current: usize, total: usize, context: ?*anyopaque) callconv(.c) bool {
+            const last: *[2]usize = @ptrCast(@alignCast(context.?));
+            last.* = .{ current, total };
+            return true;
+        }
+    };
+
+    var last = [2]usize{ 0, 0 };
+    const rc = szf_process_fd(ctx, file.handle, Progress.onProgress, &last, null, null);
+    try std.testing.expectEqual(SZF_OK, rc);
+    try std.testing.expectEqual(@as(usize, payload.len), last[0]);
+    try std.testing.expectEqual(@as(usize, payload.len), last[1]);
+
+    try std.testing.expectEqual(SZF_ERR_NOT_FOUND, szf_process_path(ctx, "/nonexistent/szf-input", null, null, null, null));
+}
+
+test "process fd starts at the current offset on both paths" {
+    const ctx = szf_context_new().?;
+    defer szf_context_free(ctx);
+
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+
+    const Progress = struct {
+        fn onProgress(current: usize, total: usize, context: ?*anyopaque) callconv(.c) bool {
+            const last: *[2]usize = @ptrCast(@alignCast(context.?));
+            last.* = .{ current, total };
+            return true;
+        }
+    };
+
+    // Below and above the mmap threshold; the offset is not page-aligned
+    const skip: usize = 5000;
+    for ([_]usize{ 20_000, SZF_MMAP_THRESHOLD + 12_345 }) |len| {
+        const payload = try std.testing.allocator.alloc(u8, len);
+        defer std.testing.allocator.free(payload);
+        @memset(payload, 'x');
+        try tmp.dir.writeFile(.{ .sub_path = "seeked.log", .data = payload });
+
+        const file = try tmp.dir.openFile("seeked.log", .{});
+        defer file.close();
+        try file.seekTo(skip);
+
+        var last = [2]usize{ 0, 0 };
+        try std.testing.expectEqual(SZF_OK, szf_process_fd(ctx, file.handle, Progress.onProgress, &last, null, null));
+        try std.testing.expectEqual(len - skip, last[0]);
+        try std.testing.expectEqual(len - skip, last[1]);
+        try std.testing.expectEqual(@as(u64, len), try file.getPos());
+    }
+}
+
+test "slab context reuses released buffers" {
+    try std.testing.expect(szf_context_new_ex(42) == null);
+
+    const ctx = szf_context_new_ex(SZF_ALLOC_SLAB).?;
+    defer szf_context_free(ctx);
+
+    const input = SzfBytes.fromSlice("hello world");
+    var first: SzfBytes = undefined;
+    try std.testing.expectEqual(SZF_OK, szf_transform_data(ctx, input, &first));
+    const first_ptr = first.ptr;
+    szf_context_release_bytes(ctx, &first);
+
+    var second: SzfBytes = undefined;
+    try std.testing.expectEqual(SZF_OK, szf_transform_data(ctx, input, &second));
+    try std.testing.expectEqual(first_ptr, second.ptr);
+    try std.testing.expectEqualStrings("HELLO WORLD", second.toSlice());
+
+    var stats: SzfAllocStats = undefined;
+    try std.testing.expectEqual(SZF_OK, szf_context_get_stats(ctx, &stats));
+    try std.testing.expectEqual(SZF_ALLOC_SLAB, stats.mode);
+    try std.testing.expectEqual(@as(usize, 11), stats.bytes_live);
+    try std.testing.expectEqual(@as(u64, 1), stats.slab_hits);
+
+    szf_context_reset(ctx);
+    try std.testing.expectEqual(SZF_OK, szf_context_get_stats(ctx, &stats));
+    try std.testing.expectEqual(@as(usize, 0), stats.bytes_live);
+    try std.testing.expectEqual(@as(usize, 11), stats.bytes_peak);
+}
+
+test {
+    _ = slab;
+}
@@ -0,0 +1,267 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//! Swift-Zig FFI - Size-Class Slab Allocator
+//!
+//! Backs SzfContext in SZF_ALLOC_SLAB mode. Small requests are served from
+//! per-size-class free lists carved out of 64 KiB slabs, and freed blocks go
+//! straight back on their list for reuse. Requests above the largest class
+//! go to the backing allocator and are tracked so reset() can reclaim them.
+//!
+//! Not thread-safe: each context owns its own instance, so with one context
+//! per thread every thread gets private slabs without any locking.
+
+const std = @import("std");
+const Alignment = std.mem.Alignment;
+
+/// Bytes carved from the backing allocator per slab
+pub const slab_size: usize = 64 * 1024;
+
+/// Smallest size class (16 bytes); also the minimum block size
+const min_class_shift = 4;
+/// Largest size class (4 KiB); anything bigger is a large allocation
+const max_class_shift = 12;
+const max_class_size: usize = 1 << max_class_shift;
+const class_count = max_class_shift - min_class_shift + 1;
+
+pub const Stats = struct {
+    /// Bytes currently handed out (requested sizes)
+    bytes_live: usize = 0,
+    /// High-water mark of bytes_live since init
+    bytes_peak: usize = 0,
+    /// Bytes held from the backing allocator (slabs + large blocks)
+    bytes_reserved: usize = 0,
+    /// Small allocations served from a free list
+    slab_hits: u64 = 0,
+    /// Small allocations that had to carve a fresh block
+    slab_misses: u64 = 0,
+    /// Allocations routed to the backing allocator
+    large_allocs: u64 = 0,
+};
+
+const FreeNode = struct {
+    next: ?*FreeNode,
+};
+
+const SizeClass = struct {
+    free: ?*FreeNode = null,
+    /// Uncarved tail of the newest slab for this class
+    bump: [*]u8 = undefined,
+    bump_left: usize = 0,
+};
+
+const LargeAlloc = struct {
+    len: usize,
+    alignment: Alignment,
+};
+
+pub const SlabAllocator = struct {
+    backing: std.mem.Allocator,
+    classes: [class_count]SizeClass = [_]SizeClass{.{}} ** class_count,
+    slabs: std.ArrayListUnmanaged([]align(max_class_size) u8) = .{},
+    large: std.AutoHashMapUnmanaged(usize, LargeAlloc) = .{},
+    stats: Stats = .{},
+
+    const Self = @This();
+
+    const vtable = std.mem.Allocator.VTable{
+        .alloc = alloc,
+        .resize = resize,
+        .remap = remap,
+        .free = free,
+    };
+
+    pub fn init(backing: std.mem.Allocator) Self {
+        return .{ .backing = backing };
+    }
+
+    pub fn deinit(self: *Self) void {
+        self.reset();
+        self.slabs.deinit(self.backing);
+        self.large.deinit(self.backing);
+    }
+
+    pub fn allocator(self: *Self) std.mem.Allocator {
+        return .{ .ptr = self, .vtable = &vtable };
+    }
+
+    /// Release every slab and large block back to the backing allocator.
+    /// Invalidates all outstanding allocations; keeps the peak statistic.
+    pub fn reset(self: *Self) void {
+        for (self.slabs.items) |slab| self.backing.free(slab);
+        self.slabs.clearRetainingCapacity();
+
+        var it = self.large.iterator();
+        while (it.next()) |entry| {
+            const ptr: [*]u8 = @ptrFromInt(entry.key_ptr.*);
+            self.backing.rawFree(ptr[0..entry.value_ptr.len], entry.value_ptr.alignment, @returnAddress());
+        }
+        self.large.clearRetainingCapacity();
+
+        self.classes = [_]SizeClass{.{}} ** class_count;
+        self.stats.bytes_live = 0;
+        self.stats.bytes_reserved = 0;
+    }
+
+    fn classIndex(len: usize, alignment: Alignment) ?usize {
+        const size = @max(len, alignment.toByteUnits(), 1 << min_class_shift);
+        if (size > max_class_size) return null;
+        return std.math.log2_int_ceil(usize, size) - min_class_shift;
+    }
+
+    fn classSize(index: usize) usize {
+        return @as(usize, 1) << @intCast(index + min_class_shift);
+    }
+
+    fn allocSmall(self: *Self, index: usize) ?[*]u8 {
+        const class = &self.classes[index];
+        if (class.free) |node| {
+            class.free = node.next;
+            self.stats.slab_hits += 1;
+            return @ptrCast(node);
+        }
+
+        self.stats.slab_misses += 1;
+        const block = classSize(index);
+        if (class.bump_left < block) {
+            const slab = self.backing.alignedAlloc(u8, max_class_size, slab_size) catch return null;
+            self.slabs.append(self.backing, slab) catch {
+                self.backing.free(slab);
+                return null;
+            };
+            self.stats.bytes_reserved += slab_size;
+            class.bump = slab.ptr;
+            class.bump_left = slab_size;
+        }
+
+        const ptr = class.bump;
+        class.bump += block;
+        class.bump_left -= block;
+        return ptr;
+    }
+
+    fn allocLarge(self: *Self, len: usize, alignment: Alignment) ?[*]u8 {
+        self.large.ensureUnusedCapacity(self.backing, 1) catch return null;
+        const ptr = self.backing.rawAlloc(len, alignment, @returnAddress()) orelse return null;
+        self.large.putAssumeCapacity(@intFromPtr(ptr), .{ .len = len, .alignment = alignment });
+        self.stats.large_allocs += 1;
+        self.stats.bytes_reserved += len;
+        return ptr;
+    }
+
+    fn trackLive(self: *Self, old_len: usize, new_len: usize) void {
+        self.stats.bytes_live = self.stats.bytes_live - old_len + new_len;
+        self.stats.bytes_peak = @max(self.stats.bytes_peak, self.stats.bytes_live);
+    }
+
+    fn alloc(ctx: *anyopaque, len: usize, alignment: Alignment, ret_addr: usize) ?[*]u8 {
+        _ = ret_addr;
+        const self: *Self = @ptrCast(@alignCast(ctx));
+        const ptr = if (classIndex(len, alignment)) |index|
+            self.allocSmall(index)
+        else
+            self.allocLarge(len, alignment);
+
+        if (ptr != null) self.trackLive(0, len);
+        return ptr;
+    }
+
+    fn resize(ctx: *anyopaque, memory: []u8, alignment: Alignment, new_len: usize, ret_addr: usize) bool {
+        const self: *Self = @ptrCast(@alignCast(ctx));
+
+        if (classIndex(memory.len, alignment)) |index| {
+            // Small blocks can change size only within their own class
+            if (classIndex(new_len, alignment) != index) return false;
+        } else {
+            if (classIndex(new_len, alignment) != null) return false;
+            if (!self.backing.rawResize(memory, alignment, new_len, ret_addr)) return false;
+            self.updateLarge(memory, memory.ptr, new_len);
+        }
+
+        self.trackLive(memory.len, new_len);
+        return true;
+    }
+
+    fn remap(ctx: *anyopaque, memory: []u8, alignment: Alignment, new_len: usize, ret_addr: usize) ?[*]u8 {
+        const self: *Self = @ptrCast(@alignCast(ctx));
+
+        if (classIndex(memory.len, alignment) != null) {
+            return if (resize(ctx, memory, alignment, new_len, ret_addr)) memory.ptr else null;
+        }
+        if (classIndex(new_len, alignment) != null) return null;
+
+        const new_ptr = self.backing.rawRemap(memory, alignment, new_len, ret_addr) orelse return null;
+        self.updateLarge(memory, new_ptr, new_len);
+        self.trackLive(memory.len, new_len);
+        return new_ptr;
+    }
+
+    fn updateLarge(self: *Self, memory: []u8, new_ptr: [*]u8, new_len: usize) void {
+        const entry = self.large.fetchRemove(@intFromPtr(memory.ptr)) orelse unreachable;
+        // Removal freed a slot, so this cannot fail
+        self.large.putAssumeCapacity(@intFromPtr(new_ptr), .{ .len = new_len, .alignment = entry.value.alignment });
+        self.stats.bytes_reserved = self.stats.bytes_reserved - memory.len + new_len;
+    }
+
+    fn free(ctx: *anyopaque, memory: []u8, alignment: Alignment, ret_addr: usize) void {
+        const self: *Self = @ptrCast(@alignCast(ctx));
+
+        if (classIndex(memory.len, alignment)) |index| {
+            const node: *FreeNode = @ptrCast(@alignCast(memory.ptr));
+            node.next = self.classes[index].free;
+            self.classes[index].free = node;
+        } else {
+            _ = self.large.remove(@intFromPtr(memory.ptr));
+            self.backing.rawFree(memory, alignment, ret_addr);
+            self.stats.bytes_reserved -= memory.len;
+        }
+
+        self.trackLive(memory.len, 0);
+    }
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "freed blocks are reused" {
+    var slab = SlabAllocator.init(std.testing.allocator);
+    defer slab.deinit();
+    const a = slab.allocator();
+
+    const first = try a.alloc(u8, 100);
+    a.free(first);
+    const second = try a.alloc(u8, 120);
+    defer a.free(second);
+
+    // 100 and 120 share the 128-byte class
+    try std.testing.expectEqual(first.ptr, second.ptr);
+    try std.testing.expectEqual(@as(u64, 1), slab.stats.slab_hits);
+    try std.testing.expectEqual(@as(usize, 120), slab.stats.bytes_live);
+    try std.testing.expectEqual(@as(usize, 120), slab.stats.bytes_peak);
+}
+
+test "large allocations bypass slabs and are reclaimed by reset" {
+    var slab = SlabAllocator.init(std.testing.allocator);
+    defer slab.deinit();
+    const a = slab.allocator();
+
+    const big = try a.alloc(u8, 64 * 1024);
+    try std.testing.expectEqual(@as(u64, 1), slab.stats.large_allocs);
+    try std.testing.expect(slab.stats.bytes_live >= big.len);
+
+    // Leak on purpose: reset must return it to the backing allocator
+    _ = try a.alloc(u64, 10);
+    slab.reset();
+    try std.testing.expectEqual(@as(usize, 0), slab.stats.bytes_live);
+    try std.testing.expectEqual(@as(usize, 0), slab.stats.bytes_reserved);
+    try std.testing.expect(slab.stats.bytes_peak >= big.len);
+}
+
+test "alignment is honoured" {
+    var slab = SlabAllocator.init(std.testing.allocator);
+    defer slab.deinit();
+    const a = slab.allocator();
+
+    const p = try a.alignedAlloc(u8, 256, 8);
+    defer a.free(p);
+    try std.testing.expect(std.mem.isAligned(@intFromPtr(p.ptr), 256));
+}
@@ -18,6 +18,7 @@ public enum ZigError: Error, CustomStringConvertible {
     case notFound
     case alreadyExists
     case callbackFailed
+    case ioError
     case notImplemented
     case unknown(code: Int32, message: String?)
 
@@ -30,6 +31,7 @@ public enum ZigError: Error, CustomStringConvertible {
         case .notFound: return "Not found"
         case .alreadyExists: return "Already exists"
         case .callbackFailed: return "Callback failed"
+        case .ioError: return "I/O error"
         case .notImplemented: return "Not implemented"
         case .unknown(let code, let message):
             return message ?? "Unknown error (code: \(code))"
@@ -46,6 +48,7 @@ public enum ZigError: Error, CustomStringConvertible {
         case SZF_ERR_NOT_FOUND: return .notFound
         case SZF_ERR_ALREADY_EXISTS: return .alreadyExists
         case SZF_ERR_CALLBACK_FAILED: return .callbackFailed
+        case SZF_ERR_IO: return .ioError
         case SZF_ERR_NOT_IMPLEMENTED: return .notImplemented
         default: return .unknown(code: code, message: msg)
         }
@@ -54,12 +57,36 @@ public enum ZigError: Error, CustomStringConvertible {
 
 // MARK: - Context
 
+/// Allocation strategy for a context
+public enum ZigAllocatorMode {
+    /// One arena per context, reclaimed only by reset()
+    case arena
+    /// Size-class slabs with individual free, for long-lived contexts
+    case slab
+
+    internal var rawValue: Int32 {
+        switch self {
+        case .arena: return SZF_ALLOC_ARENA
+        case .slab: return SZF_ALLOC_SLAB
+        }
+    }
+}
+
 /// Manages Zig library context and memory
 public final class ZigContext {
     private var ctx: OpaquePointer?
 
-    public init() throws {
-        ctx = szf_context_new()
+    // Per-context handlers (the context itself is passed as callback context)
+    private var eventHandler: EventHandler?
+    private var errorHandler: ErrorHandler?
+
+    // Swift-side mirror of the context's intern table, so repeated keys skip
+    // both the FFI crossing and String bridging
+    private var internedHandles: [String: Int32] = [:]
+    private var internedStrings: [Int32: String] = [:]
+
+    public init(allocatorMode: ZigAllocatorMode = .arena) throws {
+        ctx = szf_context_new_ex(allocatorMode.rawValue)
         guard ctx != nil else {
             throw ZigError.allocationFailed
         }
@@ -76,12 +103,93 @@ public final class ZigContext {
         szf_context_reset(ctx)
     }
 
+    /// Allocator statistics (bytes live/peak/reserved, slab hits)
+    public var allocatorStats: SzfAllocStats {
+        var stats = SzfAllocStats()
+        _ = szf_context_get_stats(ctx, &stats)
+        return stats
+    }
+
     /// Get last error message
     public var lastError: String? {
         guard let msg = szf_context_get_error(ctx) else { return nil }
         return String(cString: msg)
     }
 
+    /// Register an event handler for this context only (Zig → Swift)
+    public func setEventHandler(_ handler: EventHandler?) {
+        eventHandler = handler
+
+        guard handler != nil else {
+            _ = szf_context_register_event_callback(ctx, nil, nil)
+            return
+        }
+
+        let selfPtr = Unmanaged.passUnretained(self).toOpaque()
+        _ = szf_context_register_event_callback(ctx, { eventType, data, user in
+            guard let user = user else { return }
+            let context = Unmanaged<ZigContext>.fromOpaque(user).takeUnretainedValue()
+            let swiftData: Data
+            if let ptr = data.ptr, data.len > 0 {
+                swiftData = Data(bytes: ptr, count: data.len)
+            } else {
+                swiftData = Data()
+            }
+            context.eventHandler?(eventType, swiftData)
+        }, selfPtr)
+    }
+
+    /// Register an error handler for this context only (Zig → Swift)
+    public func setErrorHandler(_ handler: ErrorHandler?) {
+        errorHandler = handler
+
+        guard handler != nil else {
+            _ = szf_context_register_error_callback(ctx, nil, nil)
+            return
+        }
+
+        let selfPtr = Unmanaged.passUnretained(self).toOpaque()
+        _ = szf_context_register_error_callback(ctx, { code, message, user in
+            guard let user = user else { return }
+            let context = Unmanaged<ZigContext>.fromOpaque(user).takeUnretainedValue()
+            context.errorHandler?(code, message.map { String(cString: $0) })
+        }, selfPtr)
+    }
+
+    /// Intern a string and return its stable handle
+    public func intern(_ string: String) throws -> Int32 {
+        if let handle = internedHandles[string] {
+            return handle
+        }
+
+        var utf8 = string
+        let handle = utf8.withUTF8 { buffer in
+            buffer.withMemoryRebound(to: CChar.self) { chars in
+                szf_string_intern(ctx, chars.baseAddress, chars.count)
+            }
+        }
+        guard handle >= 0 else {
+            throw ZigError.from(code: handle, message: szf_context_get_error(ctx))
+        }
+
+        internedHandles[string] = handle
+        internedStrings[handle] = string
+        return handle
+    }
+
+    /// Resolve an interned handle back to a Swift String
+    public func internedString(_ handle: Int32) -> String? {
+        if let string = internedStrings[handle] {
+            return string
+        }
+
+        let str = szf_string_interned(ctx, handle)
+        guard let ptr = str.ptr else { return nil }
+        let string = String(cString: ptr)
+        internedStrings[handle] = string
+        return string
+    }
+
     internal var pointer: OpaquePointer? { ctx }
 }
 
@@ -186,36 +294,40 @@ public func registerErrorHandler(_ handler: ErrorHandler?) {
 
 // MARK: - Operations
 
-/// Process data with progress and result callbacks
-public func processData(
-    context: ZigContext,
-    input: ZigBytes,
-    progress: ProgressHandler? = nil,
-    completion: @escaping ResultHandler
-) {
-    // Store closures in context to prevent release
-    class CallbackContext {
-        var progress: ProgressHandler?
-        var completion: ResultHandler?
-    }
-
-    let callbackCtx = CallbackContext()
-    callbackCtx.progress = progress
-    callbackCtx.completion = completion
+// Stores closures for the duration of an szf_process_* call.
+// Retained when passed to Zig, released by the result callback.
+private final class ProcessCallbackContext {
+    var progress: ProgressHandler?
+    var completion: ResultHandler?
 
-    let ctxPtr = Unmanaged.passRetained(callbackCtx).toOpaque()
+    init(progress: ProgressHandler?, completion: ResultHandler?) {
+        self.progress = progress
+        self.completion = completion
+    }
 
-    let progressCb: SzfProgressCallback? = progress != nil ? { current, total, ctx in
+    static let progressCallback: SzfProgressCallback = { current, total, ctx in
         guard let ctx = ctx else { return true }
-        let callbackCtx = Unmanaged<CallbackContext>.fromOpaque(ctx).takeUnretainedValue()
+        let callbackCtx = Unmanaged<ProcessCallbackContext>.fromOpaque(ctx).takeUnretainedValue()
         return callbackCtx.progress?(Int(current), Int(total)) ?? true
-    } : nil
+    }
 
-    let resultCb: SzfResultCallback = { result, ctx in
+    static let resultCallback: SzfResultCallback = { result, ctx in
         guard let ctx = ctx else { return }
-        let callbackCtx = Unmanaged<CallbackContext>.fromOpaque(ctx).takeRetainedValue()
+        let callbackCtx = Unmanaged<ProcessCallbackContext>.fromOpaque(ctx).takeRetainedValue()
         callbackCtx.completion?(ZigResult(from: result))
     }
+}
+
+/// Process data with progress and result callbacks
+public func processData(
+    context: ZigContext,
+    input: ZigBytes,
+    progress: ProgressHandler? = nil,
+    completion: @escaping ResultHandler
+) {
+    let callbackCtx = ProcessCallbackContext(progress: progress, completion: completion)
+    let ctxPtr = Unmanaged.passRetained(callbackCtx).toOpaque()
+    let progressCb = progress != nil ? ProcessCallbackContext.progressCallback : nil
 
     input.withCBytes { bytes in
         _ = szf_process_data(
@@ -223,12 +335,59 @@ public func processData(
             bytes,
             progressCb,
             ctxPtr,
-            resultCb,
+            ProcessCallbackContext.resultCallback,
             ctxPtr
         )
     }
 }
 
+/// Process a file by path without loading it into memory.
+/// Large files are memory-mapped; progress is reported in bytes.
+public func processFile(
+    context: ZigContext,
+    path: String,
+    progress: ProgressHandler? = nil,
+    completion: @escaping ResultHandler
+) {
+    let callbackCtx = ProcessCallbackContext(progress: progress, completion: completion)
+    let ctxPtr = Unmanaged.passRetained(callbackCtx).toOpaque()
+    let progressCb = progress != nil ? ProcessCallbackContext.progressCallback : nil
+
+    path.withCString { cPath in
+        _ = szf_process_path(
+            context.pointer,
+            cPath,
+            progressCb,
+            ctxPtr,
+            ProcessCallbackContext.resultCallback,
+            ctxPtr
+        )
+    }
+}
+
+/// Process everything readable from an open file descriptor (not closed),
+/// from its current offset to the end.
+/// Progress `total` is 0 when the size is unknown (pipes, sockets).
+public func processFileDescriptor(
+    context: ZigContext,
+    fd: Int32,
+    progress: ProgressHandler? = nil,
+    completion: @escaping ResultHandler
+) {
+    let callbackCtx = ProcessCallbackContext(progress: progress, completion: completion)
+    let ctxPtr = Unmanaged.passRetained(callbackCtx).toOpaque()
+    let progressCb = progress != nil ? ProcessCallbackContext.progressCallback : nil
+
+    _ = szf_process_fd(
+        context.pointer,
+        fd,
+        progressCb,
+        ctxPtr,
+        ProcessCallbackContext.resultCallback,
+        ctxPtr
+    )
+}
+
 /// Transform data (example: uppercase)
 public func transformData(context: ZigContext, input: ZigBytes) throws -> Data {
     var output = SzfBytes()